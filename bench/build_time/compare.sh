@@ -0,0 +1,22 @@
+#!/bin/sh
+# Собирает синтетический проект дважды (через zip.h и через модуль zipcpp) и выводит время каждой сборки.
+# Аргументы: [каталог сборки] [количество единиц трансляции]. Генератор Ninja нужен CMake для сборки модулей.
+set -e
+SOURCE_DIR=$(cd "$(dirname "$0")" && pwd)
+BUILD_DIR=${1:-build_time}
+UNITS=${2:-64}
+JOBS=$(nproc 2>/dev/null || echo 1)
+
+cmake -S "$SOURCE_DIR" -B "$BUILD_DIR" -G Ninja -DBUILD_TIME_UNITS="$UNITS" -DCMAKE_BUILD_TYPE=Release > /dev/null
+
+measure() {
+    cmake --build "$BUILD_DIR" --target clean > /dev/null
+    start=$(date +%s.%N)
+    cmake --build "$BUILD_DIR" --target "$1" -j "$JOBS" > /dev/null
+    end=$(date +%s.%N)
+    echo "$1: $(echo "$end - $start" | bc) s"
+}
+
+measure build_time_header
+# Время сборки с модулем включает компиляцию самого интерфейса модуля.
+measure build_time_module
@@ -0,0 +1,63 @@
+/* Сравнение поиска первой отличающейся строки двух объектов Zip из трех столбцов через std::mismatch
+ *  (оператор == кортежей строк) и zipcpp::mismatch, а также поиска строки по условию через std::find_if
+ *  и zipcpp::find_if_row. Различие находится в последней строке, поэтому просматриваются все строки.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "zip.h"
+#include "zip_compare.h"
+
+using namespace std;
+
+namespace {
+    constexpr size_t kRows = 1 << 14;
+    constexpr int kRepetitions = 101;
+
+    template <typename F>
+    double BestNanosecondsPerRow(F&& f) {
+        double best = 1e300;
+        for (int i = 0; i < kRepetitions; ++i) {
+            auto start = chrono::steady_clock::now();
+            f();
+            chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+            best = min(best, elapsed.count() / kRows);
+        }
+        return best;
+    }
+}
+
+int main() {
+    vector<int64_t> a1(kRows), b1(kRows);
+    vector<double> a2(kRows), b2(kRows);
+    vector<int32_t> a3(kRows), b3(kRows);
+    for (size_t i = 0; i < kRows; ++i) {
+        a1[i] = b1[i] = static_cast<int64_t>(i);
+        a2[i] = b2[i] = static_cast<double>(i) / 3;
+        a3[i] = b3[i] = static_cast<int32_t>(i % 100);
+    }
+    b3[kRows - 1] = -1;
+    auto left = zipcpp::zip(a1, a2, a3);
+    auto right = zipcpp::zip(b1, b2, b3);
+
+    volatile long sink = 0;
+    double std_mismatch = BestNanosecondsPerRow([&] {
+        sink = sink + (mismatch(left.begin(), left.end(), right.begin(), right.end()).first - left.begin());
+    });
+    double zip_mismatch = BestNanosecondsPerRow([&] {
+        sink = sink + (zipcpp::mismatch(left, right).first - left.begin());
+    });
+    auto last_row = [](const auto& row) { return get<2>(row) < 0; };
+    double std_find = BestNanosecondsPerRow([&] {
+        sink = sink + (find_if(right.begin(), right.end(), last_row) - right.begin());
+    });
+    double zip_find = BestNanosecondsPerRow([&] {
+        sink = sink + (zipcpp::find_if_row(right, last_row) - right.begin());
+    });
+
+    printf("mismatch: std %.3f ns/row, zipcpp %.3f ns/row\n", std_mismatch, zip_mismatch);
+    printf("find_if:  std %.3f ns/row, zipcpp %.3f ns/row\n", std_find, zip_find);
+    return 0;
+}
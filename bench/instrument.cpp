@@ -0,0 +1,76 @@
+/* Сравнение цикла по zip с циклом по индексам.
+ * Программа собирается дважды: bench_instrument без ZIPCPP_INSTRUMENT проверяет, что точки подсчета не влияют
+ *  на сгенерированный код (время цикла по zip совпадает с временем цикла по индексам), а
+ *  bench_instrument_on с ZIPCPP_INSTRUMENT показывает стоимость подсчета и выводит отчет.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "zip.h"
+
+using namespace std;
+using zipcpp::zip;
+
+namespace {
+    constexpr size_t kRows = 1 << 22;
+    constexpr int kRepetitions = 7;
+
+    template <typename F>
+    double BestNanosecondsPerRow(F&& f) {
+        double best = 1e300;
+        for (int i = 0; i < kRepetitions; ++i) {
+            auto start = chrono::steady_clock::now();
+            f();
+            chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+            best = min(best, elapsed.count() / kRows);
+        }
+        return best;
+    }
+}
+
+int main() {
+    vector<long> a(kRows), b(kRows);
+    for (size_t i = 0; i < kRows; ++i) {
+        a[i] = static_cast<long>(i);
+        b[i] = static_cast<long>(i % 7);
+    }
+
+    volatile long sink = 0;
+    double manual = BestNanosecondsPerRow([&] {
+        long sum = 0;
+        for (size_t i = 0; i < kRows; ++i)
+            sum += a[i] * b[i];
+        sink = sum;
+    });
+    double zipped = BestNanosecondsPerRow([&] {
+        ZIPCPP_LOOP("bench");
+        long sum = 0;
+        for (const auto& [x, y] : zip(a, b))
+            sum += x * y;
+        sink = sum;
+    });
+    (void)sink;
+
+    double ratio = zipped / manual;
+    printf("index loop: %.3f ns/row\nzip loop:   %.3f ns/row\nratio:      %.2f\n", manual, zipped, ratio);
+#if defined(ZIPCPP_INSTRUMENT)
+    for (const auto& site : zipcpp::instrument::report()) {
+        printf("%s (%s:%d): loops=%llu advances=%llu iterator_advances=%llu dereferences=%llu comparisons=%llu\n",
+               site.name, site.file, site.line, static_cast<unsigned long long>(site.loops),
+               static_cast<unsigned long long>(site.totals.advances),
+               static_cast<unsigned long long>(site.totals.iterator_advances),
+               static_cast<unsigned long long>(site.totals.dereferences),
+               static_cast<unsigned long long>(site.totals.comparisons));
+    }
+    return 0;
+#else
+    // Без ZIPCPP_INSTRUMENT цикл по zip не должен заметно отличаться от цикла по индексам.
+    if (ratio > 1.5) {
+        printf("FAIL: zip loop is slower than the index loop with instrumentation disabled\n");
+        return 1;
+    }
+    printf("OK: instrumentation compiled away\n");
+    return 0;
+#endif
+}
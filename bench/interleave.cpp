@@ -0,0 +1,76 @@
+/* Сравнение раскладки массива записей { float x, y, z } в три столбца и обратной сборки обычным циклом
+ *  и функциями zipcpp::deinterleave / zipcpp::interleave. Данные помещаются в кэш второго уровня, поэтому
+ *  сравнивается стоимость перестановок, а не пропускная способность памяти. Выходные векторы заранее имеют
+ *  нужную емкость и в обоих вариантах заполняются заново.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "zip.h"
+#include "zip_interleave.h"
+
+using namespace std;
+
+namespace {
+    constexpr size_t kRecords = 1 << 13;
+    constexpr int kRepetitions = 101;
+
+    struct Point {
+        float x, y, z;
+    };
+
+    template <typename F>
+    double BestNanosecondsPerRecord(F&& f) {
+        double best = 1e300;
+        for (int i = 0; i < kRepetitions; ++i) {
+            auto start = chrono::steady_clock::now();
+            f();
+            chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+            best = min(best, elapsed.count() / kRecords);
+        }
+        return best;
+    }
+}
+
+int main() {
+    vector<Point> points(kRecords);
+    for (size_t i = 0; i < kRecords; ++i)
+        points[i] = Point{float(i), float(i % 7), -float(i)};
+    vector<float> xs, ys, zs;
+    vector<Point> restored;
+
+    double scalar_split = BestNanosecondsPerRecord([&] {
+        xs.clear();
+        ys.clear();
+        zs.clear();
+        xs.resize(kRecords);
+        ys.resize(kRecords);
+        zs.resize(kRecords);
+        for (size_t i = 0; i < kRecords; ++i) {
+            xs[i] = points[i].x;
+            ys[i] = points[i].y;
+            zs[i] = points[i].z;
+        }
+    });
+    double simd_split = BestNanosecondsPerRecord([&] {
+        xs.clear();
+        ys.clear();
+        zs.clear();
+        zipcpp::deinterleave(points, xs, ys, zs);
+    });
+    double scalar_join = BestNanosecondsPerRecord([&] {
+        restored.clear();
+        restored.resize(kRecords);
+        for (size_t i = 0; i < kRecords; ++i)
+            restored[i] = Point{xs[i], ys[i], zs[i]};
+    });
+    double simd_join = BestNanosecondsPerRecord([&] {
+        restored.clear();
+        zipcpp::interleave(zipcpp::zip(xs, ys, zs), restored);
+    });
+
+    printf("deinterleave: loop %.3f ns/record, zipcpp %.3f ns/record\n", scalar_split, simd_split);
+    printf("interleave:   loop %.3f ns/record, zipcpp %.3f ns/record\n", scalar_join, simd_join);
+    return 0;
+}
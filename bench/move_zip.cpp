@@ -0,0 +1,73 @@
+/* Сравнение переноса строк из столбцов в вектор кортежей при обходе zip (значения копируются)
+ *  и move_zip (значения перемещаются). Строки длиннее буфера малых строк, поэтому каждая копия выделяет память.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "zip.h"
+
+using namespace std;
+using zipcpp::zip;
+using zipcpp::move_zip;
+
+namespace {
+    constexpr size_t kRows = 1 << 18;
+    constexpr int kRepetitions = 7;
+
+    using Row = tuple<string, string, long>;
+
+    struct Columns {
+        vector<string> names;
+        vector<string> comments;
+        vector<long> ids;
+    };
+
+    Columns MakeColumns() {
+        Columns columns;
+        for (size_t i = 0; i < kRows; ++i) {
+            columns.names.push_back(string(48, static_cast<char>('a' + i % 26)));
+            columns.comments.push_back(string(96, static_cast<char>('A' + i % 26)));
+            columns.ids.push_back(static_cast<long>(i));
+        }
+        return columns;
+    }
+
+    // Столбцы создаются заново перед каждым повторением, так как move_zip оставляет их перемещенными.
+    template <typename F>
+    double BestNanosecondsPerRow(F&& f) {
+        double best = 1e300;
+        for (int i = 0; i < kRepetitions; ++i) {
+            Columns columns = MakeColumns();
+            vector<Row> rows;
+            rows.reserve(kRows);
+            auto start = chrono::steady_clock::now();
+            f(columns, rows);
+            chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+            best = min(best, elapsed.count() / kRows);
+        }
+        return best;
+    }
+}
+
+int main() {
+    double copied = BestNanosecondsPerRow([](Columns& columns, vector<Row>& rows) {
+        auto z = zip(columns.names, columns.comments, columns.ids);
+        std::copy(z.begin(), z.end(), back_inserter(rows));
+    });
+    double moved = BestNanosecondsPerRow([](Columns& columns, vector<Row>& rows) {
+        auto z = move_zip(columns.names, columns.comments, columns.ids);
+        std::copy(z.begin(), z.end(), back_inserter(rows));
+    });
+
+    printf("zip copy:      %.3f ns/row\nmove_zip move: %.3f ns/row\nspeedup:       %.2f\n", copied, moved, copied / moved);
+    if (moved >= copied) {
+        printf("FAIL: move_zip is not faster than copying\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
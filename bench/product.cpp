@@ -0,0 +1,67 @@
+/* Сравнение перебора всех пар элементов двух векторов вложенными циклами и через zipcpp::product.
+ * Второй вектор не помещается в кэш, поэтому вложенные циклы читают его из памяти для каждого элемента первого вектора,
+ *  а product перебирает пары плитками, помещающимися в кэш первого уровня.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "zip.h"
+#include "zip_product.h"
+
+using namespace std;
+using zipcpp::product;
+
+namespace {
+    constexpr size_t kOuter = 256;
+    constexpr size_t kInner = 1 << 22;
+    constexpr int kRepetitions = 5;
+
+    template <typename F>
+    double BestNanosecondsPerPair(F&& f) {
+        double best = 1e300;
+        for (int i = 0; i < kRepetitions; ++i) {
+            auto start = chrono::steady_clock::now();
+            f();
+            chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+            best = min(best, elapsed.count() / (kOuter * kInner));
+        }
+        return best;
+    }
+}
+
+int main() {
+    vector<float> a(kOuter), b(kInner);
+    for (size_t i = 0; i < kOuter; ++i)
+        a[i] = static_cast<float>(i % 97);
+    for (size_t i = 0; i < kInner; ++i)
+        b[i] = static_cast<float>(i % 89);
+
+    // Количество пар, расстояние между элементами которых меньше порога.
+    volatile long sink = 0;
+    double nested = BestNanosecondsPerPair([&] {
+        long close = 0;
+        for (float x : a)
+            for (float y : b)
+                close += (x - y) * (x - y) < 4.0f;
+        sink = close;
+    });
+    double tiled = BestNanosecondsPerPair([&] {
+        long close = 0;
+        for (const auto& [x, y] : product(a, b))
+            close += (x - y) * (x - y) < 4.0f;
+        sink = close;
+    });
+    double blocked = BestNanosecondsPerPair([&] {
+        long close = 0;
+        zipcpp::for_each_tile(product(a, b), [&close](const auto& row) {
+            auto [x, y] = row;
+            close += (x - y) * (x - y) < 4.0f;
+        });
+        sink = close;
+    });
+    (void)sink;
+
+    printf("nested loops:  %.3f ns/pair\nproduct:       %.3f ns/pair\nfor_each_tile: %.3f ns/pair\n", nested, tiled, blocked);
+    return 0;
+}
@@ -0,0 +1,46 @@
+/* Интерфейс модуля C++20 zipcpp. Собирается целевым объектом zip_module (опция ZIP_BUILD_MODULE) и содержит
+ *  те же пространства имен zipcpp и zip_impl, что и zip.h, поэтому код можно переводить на import zipcpp;
+ *  без изменений. Заголовочный файл zip.h по-прежнему можно использовать в C++17.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module zipcpp;
+
+#define ZIPCPP_EXPORT export
+#include "zip.h"
+
+/* Явные инстанцирования часто используемых сочетаний: объекты Zip по двум и трем векторам одного
+ *  арифметического типа. Код этих классов компилируется один раз в объектном файле модуля,
+ *  а не в каждой единице трансляции, которая его использует.
+ */
+#define ZIPCPP_INSTANTIATE_ZIP(Vector, Iter) \
+    template class zip_impl::Zip<Vector&, Vector&>; \
+    template class zip_impl::ZipIterator<Iter, Iter>; \
+    template class zip_impl::ConstZipIterator<Iter, Iter>; \
+    template class zip_impl::Zip<Vector&, Vector&, Vector&>; \
+    template class zip_impl::ZipIterator<Iter, Iter, Iter>; \
+    template class zip_impl::ConstZipIterator<Iter, Iter, Iter>;
+
+#define ZIPCPP_INSTANTIATE_VECTORS(T) \
+    ZIPCPP_INSTANTIATE_ZIP(std::vector<T>, std::vector<T>::iterator) \
+    ZIPCPP_INSTANTIATE_ZIP(const std::vector<T>, std::vector<T>::const_iterator)
+
+ZIPCPP_INSTANTIATE_VECTORS(int)
+ZIPCPP_INSTANTIATE_VECTORS(long)
+ZIPCPP_INSTANTIATE_VECTORS(float)
+ZIPCPP_INSTANTIATE_VECTORS(double)
+
+#undef ZIPCPP_INSTANTIATE_VECTORS
+#undef ZIPCPP_INSTANTIATE_ZIP
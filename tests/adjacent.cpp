@@ -0,0 +1,93 @@
+#include <deque>
+#include <list>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_adjacent.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(Adjacent, ContiguousPairs) {
+    vector<int> values = {1, 4, 9, 16, 25};
+    vector<int> differences;
+    for (auto [prev, next] : adjacent<2>(values))
+        differences.push_back(next - prev);
+    ASSERT_EQ(differences, (vector<int>{3, 5, 7, 9}));
+
+    auto windows = adjacent<2>(values);
+    ASSERT_EQ(windows.size(), 4u);
+    auto [a, b] = windows[3];
+    ASSERT_EQ(&a, &values[3]);
+    ASSERT_EQ(&b, &values[4]);
+    b = 0;
+    ASSERT_EQ(values[4], 0);
+}
+
+TEST(Adjacent, RandomAccessTriples) {
+    deque<int> values = {1, 2, 3, 4, 5};
+    vector<int> sums;
+    for (const auto& [x, y, z] : adjacent<3>(values))
+        sums.push_back(x + y + z);
+    ASSERT_EQ(sums, (vector<int>{6, 9, 12}));
+}
+
+TEST(Adjacent, ShortRange) {
+    vector<int> values = {1, 2};
+    ASSERT_EQ(adjacent<3>(values).size(), 0u);
+    vector<int> empty;
+    ASSERT_EQ(adjacent<1>(empty).size(), 0u);
+    list<int> short_list = {1, 2};
+    auto windows = adjacent<3>(short_list);
+    ASSERT_TRUE(windows.begin() == windows.end());
+}
+
+TEST(Adjacent, ForwardRange) {
+    list<string> words = {"a", "b", "c", "d"};
+    string obtained;
+    for (auto [first, second] : adjacent<2>(words)) {
+        obtained += first + second + " ";
+        first += "!";
+    }
+    ASSERT_EQ(obtained, "ab bc cd ");
+    ASSERT_EQ(words.front(), "a!");
+}
+
+TEST(Adjacent, InputRange) {
+    istringstream input("1 3 6 10 15");
+    IterRange<istream_iterator<int>> numbers{istream_iterator<int>(input), istream_iterator<int>()};
+    vector<int> differences;
+    for (const auto& [prev, next] : adjacent<2>(numbers))
+        differences.push_back(next - prev);
+    ASSERT_EQ(differences, (vector<int>{2, 3, 4, 5}));
+
+    istringstream short_input("7");
+    IterRange<istream_iterator<int>> single{istream_iterator<int>(short_input), istream_iterator<int>()};
+    auto windows = adjacent<2>(single);
+    ASSERT_TRUE(windows.begin() == windows.end());
+}
+
+TEST(Adjacent, Zip) {
+    vector<int> times = {1, 2, 4, 6};
+    vector<double> prices = {10.0, 11.0, 9.5, 12.0};
+    vector<double> speeds;
+    for (const auto& [before, after] : adjacent_zip<2>(times, prices)) {
+        const auto& [t0, p0] = before;
+        const auto& [t1, p1] = after;
+        speeds.push_back((p1 - p0) / (t1 - t0));
+    }
+    ASSERT_EQ(speeds, (vector<double>{1.0, -0.75, 1.25}));
+}
+
+TEST(Adjacent, ZipInputRange) {
+    istringstream input("5 6 8");
+    IterRange<istream_iterator<int>> numbers{istream_iterator<int>(input), istream_iterator<int>()};
+    vector<string> names = {"a", "b", "c", "d"};
+    string obtained;
+    for (const auto& [before, after] : adjacent_zip<2>(numbers, names))
+        obtained += get<1>(before) + get<1>(after) + to_string(get<0>(after) - get<0>(before)) + " ";
+    ASSERT_EQ(obtained, "ab1 bc2 ");
+}
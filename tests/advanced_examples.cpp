@@ -82,7 +82,7 @@ TEST(AdvancedIteration, SortWithZip) {
     vector<int> v1 = { 2,  4,  1,  3,  1,  1,  3,  4};
     vector<int> v2 = {22, 54, 41, 13, 11, 61, 43, 34};
     auto z = zip(v1, v2);
-    SortWithSwap(z.begin(), z.end());
+    SortWithSwap(z.begin(), z.end() - 1);  // SortWithSwap принимает последний элемент включительно
 
     const vector<int> expected1 = { 1,  1,  1,  2,  3,  3,  4,  4};
     const vector<int> expected2 = {11, 41, 61, 22, 13, 43, 34, 54};
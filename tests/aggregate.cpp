@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_aggregate.h"
+
+using namespace std;
+using namespace zipcpp;
+using namespace zip_impl;
+
+TEST(TupleHash, EqualValuesHaveEqualHashes) {
+    int a = 1, b = 1;
+    string s1 = "key", s2 = "key";
+    Tuple<int&, const string&> t1(a, s1);
+    Tuple<const int&, string&> t2(b, s2);
+    ASSERT_EQ(hash<decltype(t1)>{}(t1), hash<decltype(t2)>{}(t2));
+
+    b = 2;
+    ASSERT_NE(hash<decltype(t1)>{}(t1), hash<decltype(t2)>{}(t2));
+}
+
+TEST(TupleHash, ZipRowsAsUnorderedKeys) {
+    vector<int> a = {1, 2, 1};
+    vector<char> b = {'x', 'y', 'x'};
+    vector<size_t> hashes;
+    for (const auto& row : zip(a, b))
+        hashes.push_back(hash<decay_t<decltype(row)>>{}(row));
+    ASSERT_EQ(hashes[0], hashes[2]);
+    ASSERT_NE(hashes[0], hashes[1]);
+}
+
+TEST(HashAggregate, SingleKeyColumn) {
+    const vector<string> cities = {"rome", "oslo", "rome", "lima", "oslo", "rome"};
+    const vector<int> amounts = {5, 1, 7, 3, 2, 1};
+    auto table = hash_aggregate<0>(zip(cities, amounts), sum_of<1>{}, max_of<1>{}, row_count{});
+
+    ASSERT_EQ(table.size(), 3u);
+    vector<tuple<string, int, int, size_t>> obtained;
+    for (const auto& [key, total, largest, count] : table.rows())
+        obtained.emplace_back(get<0>(key), total, largest, count);
+    const vector<tuple<string, int, int, size_t>> expected = {
+        {"rome", 13, 7, 3},
+        {"oslo", 3, 2, 2},
+        {"lima", 3, 3, 1},
+    };
+    ASSERT_EQ(obtained, expected);
+    ASSERT_EQ(table.states<2>(), (vector<size_t>{3, 2, 1}));
+}
+
+TEST(HashAggregate, MultiColumnKeyAndGrowth) {
+    vector<int> a, b, values;
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(i % 10);
+        b.push_back(i % 7);
+        values.push_back(i);
+    }
+    auto table = hash_aggregate<0, 1>(zip(a, b, values), sum_of<2>{}, min_of<2>{});
+
+    map<pair<int, int>, pair<int, int>> expected;
+    for (int i = 0; i < 1000; ++i) {
+        auto [it, inserted] = expected.try_emplace({i % 10, i % 7}, 0, i);
+        it->second.first += i;
+    }
+    ASSERT_EQ(table.size(), expected.size());
+    for (const auto& [key, total, smallest] : table.rows()) {
+        auto found = expected.at({get<0>(key), get<1>(key)});
+        EXPECT_EQ(total, found.first);
+        EXPECT_EQ(smallest, found.second);
+    }
+}
+
+TEST(HashAggregate, ParallelMatchesSerial) {
+    vector<long> keys, values;
+    for (long i = 0; i < 20000; ++i) {
+        keys.push_back((i * 31) % 997);
+        values.push_back(i);
+    }
+    auto z = zip(keys, values);
+    auto serial = hash_aggregate<0>(z, sum_of<1>{}, row_count{}, max_of<1>{});
+    auto parallel = hash_aggregate_parallel<0>(z, 4, sum_of<1>{}, row_count{}, max_of<1>{});
+
+    auto collect = [](const auto& table) {
+        vector<tuple<long, long, size_t, long>> result;
+        for (const auto& [key, total, count, largest] : table.rows())
+            result.emplace_back(get<0>(key), total, count, largest);
+        sort(result.begin(), result.end());
+        return result;
+    };
+    ASSERT_EQ(serial.size(), 997u);
+    ASSERT_EQ(collect(serial), collect(parallel));
+
+    // Ячейки объединенной таблицы находят группы всех частей: повторное добавление строк не создает новых групп.
+    for (const auto& row : z)
+        parallel.Add(row);
+    ASSERT_EQ(parallel.size(), 997u);
+}
+
+TEST(HashAggregate, Empty) {
+    vector<int> keys;
+    auto table = hash_aggregate<0>(zip(keys), row_count{});
+    ASSERT_EQ(table.size(), 0u);
+    ASSERT_TRUE(table.rows().begin() == table.rows().end());
+}
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_compare.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(Compare, MismatchContiguousColumns) {
+    const size_t rows = 5000;
+    vector<int64_t> a1(rows), b1(rows);
+    vector<float> a2(rows), b2(rows);
+    vector<uint8_t> a3(rows), b3(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        a1[i] = b1[i] = static_cast<int64_t>(i) * 7;
+        a2[i] = b2[i] = static_cast<float>(i) / 3;
+        a3[i] = b3[i] = static_cast<uint8_t>(i);
+    }
+    auto left = zip(a1, a2, a3);
+    auto right = zip(b1, b2, b3);
+    ASSERT_TRUE((zip_impl::ComparableColumns<decltype(left.begin()), decltype(right.begin())>::value));
+    ASSERT_TRUE(equal(left, right));
+    ASSERT_TRUE(mismatch(left, right).first == left.end());
+
+    b2[4000] = -1;
+    b3[3001] = 0;
+    b1[3003] = 1;
+    auto [it_a, it_b] = mismatch(left, right);
+    ASSERT_EQ(it_a - left.begin(), 3001);
+    ASSERT_EQ(it_b - right.begin(), 3001);
+    ASSERT_FALSE(equal(left, right));
+
+    b3[3001] = a3[3001];
+    ASSERT_EQ(mismatch(left, right).first - left.begin(), 3003);
+    b1[3003] = a1[3003];
+    ASSERT_EQ(mismatch(left, right).first - left.begin(), 4000);
+}
+
+TEST(Compare, FloatingPointFollowsOperatorEquals) {
+    vector<double> a = {1.0, 0.0, 2.0, NAN, 5.0};
+    vector<double> b = {1.0, -0.0, 2.0, NAN, 5.0};
+    vector<int> ids = {1, 2, 3, 4, 5};
+    ASSERT_EQ(mismatch(zip(ids, a), zip(ids, b)).first - zip(ids, a).begin(), 3);
+}
+
+TEST(Compare, DifferentLengthsAndGenericFallback) {
+    vector<int> a = {1, 2, 3, 4};
+    vector<int> b = {1, 2, 3};
+    vector<string> names = {"a", "b", "c", "d"};
+    list<int> c = {1, 2, 3, 4};
+    ASSERT_EQ(mismatch(zip(a), zip(b)).first - zip(a).begin(), 3);
+    ASSERT_FALSE(equal(zip(a), zip(b)));
+    ASSERT_TRUE(equal(zip(a, names), zip(c, names)));
+
+    list<int> d = {1, 2, 5, 4};
+    auto [it_a, it_d] = mismatch(zip(a, names), zip(d, names));
+    ASSERT_EQ(get<1>(*it_a), "c");
+    ASSERT_EQ(get<0>(*it_d), 5);
+    ASSERT_FALSE(equal(zip(a, names), zip(d, names)));
+}
+
+TEST(Compare, FindIfRow) {
+    vector<int> a(1000), b(1000);
+    for (int i = 0; i < 1000; ++i) {
+        a[i] = i;
+        b[i] = 1000 - i;
+    }
+    auto rows = zip(a, b);
+    auto found = find_if_row(rows, [](const auto& row) { return get<0>(row) > get<1>(row); });
+    ASSERT_EQ(found - rows.begin(), 501);
+    ASSERT_TRUE(find_if_row(rows, [](const auto& row) { return get<0>(row) < 0; }) == rows.end());
+
+    auto [x, y] = *find_if_row(rows, [](const auto& row) { return get<0>(row) == 700; });
+    y = -1;
+    ASSERT_EQ(b[700], -1);
+
+    list<int> c = {5, 6, 7};
+    vector<string> names = {"x", "y", "z"};
+    auto generic = zip(c, names);
+    ASSERT_EQ(get<1>(*find_if_row(generic, [](const auto& row) { return get<0>(row) % 2 == 0; })), "y");
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_compressed.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(Compressed, DeltaRoundTrip) {
+    vector<int64_t> values;
+    for (int64_t i = 0; i < 1000; ++i)
+        values.push_back(1700000000000 + i * 15 - (i % 7) * 3);
+    values.push_back(numeric_limits<int64_t>::min());
+    values.push_back(numeric_limits<int64_t>::max());
+    values.push_back(-5);
+    delta_column column(values);
+    ASSERT_EQ(column.size(), values.size());
+    ASSERT_EQ(column.blocks(), (values.size() + 127) / 128);
+    ASSERT_LT(column.encoded_bytes(), values.size() * sizeof(int64_t) / 2);
+    ASSERT_EQ(vector<int64_t>(column.begin(), column.end()), values);
+
+    auto it = column.end();
+    for (size_t i = values.size(); i-- > 0;)
+        ASSERT_EQ(*--it, values[i]);
+
+    delta_column<uint8_t> small;
+    for (int i = 0; i < 300; ++i)
+        small.push_back(static_cast<uint8_t>(i * 37));
+    size_t index = 0;
+    for (uint8_t value : small)
+        ASSERT_EQ(value, static_cast<uint8_t>(index++ * 37));
+}
+
+TEST(Compressed, RleAndDictionary) {
+    vector<int> statuses = {1, 1, 1, 2, 2, 3, 3, 3, 3, 1};
+    rle_column rle(statuses);
+    ASSERT_EQ(rle.runs(), 4u);
+    ASSERT_EQ(vector<int>(rle.begin(), rle.end()), statuses);
+    rle.push_back(1, 5);
+    rle.push_back(7, 0);
+    ASSERT_EQ(rle.size(), 15u);
+    ASSERT_EQ(rle.runs(), 4u);
+    ASSERT_EQ(rle.begin()[4], 2);
+    ASSERT_EQ(*(rle.end() - 1), 1);
+
+    vector<string> names = {"ok", "fail", "ok", "ok", "retry", "fail"};
+    dict_column dict(names);
+    ASSERT_EQ(dict.dictionary(), (vector<string>{"ok", "fail", "retry"}));
+    ASSERT_EQ(dict.codes(), (vector<uint32_t>{0, 1, 0, 0, 2, 1}));
+    ASSERT_EQ(vector<string>(dict.begin(), dict.end()), names);
+    ASSERT_EQ(&*dict.begin(), &*(dict.begin() + 2));
+}
+
+TEST(Compressed, ZipWithSkipping) {
+    const int rows = 10000;
+    vector<int64_t> times;
+    rle_column<int> statuses;
+    dict_column<string> hosts;
+    vector<double> values;
+    for (int i = 0; i < rows; ++i) {
+        times.push_back(1000 + i * 10);
+        statuses.push_back(i / 100);
+        hosts.push_back("host" + to_string(i % 3));
+        values.push_back(i * 0.5);
+    }
+    delta_column time_column(times);
+    auto rows_zip = zip(time_column, statuses, hosts, values);
+    ASSERT_EQ(rows_zip.size(), static_cast<size_t>(rows));
+
+    int index = 0;
+    bool same = true;
+    for (auto [time, status, host, value] : rows_zip) {
+        same = same && time == 1000 + index * 10 && status == index / 100 && host == "host" + to_string(index % 3);
+        value = -value;
+        ++index;
+    }
+    ASSERT_TRUE(same);
+    ASSERT_EQ(values[10], -5.0);
+
+    auto it = rows_zip.begin();
+    it += 7321;
+    auto [time, status, host, value] = *it;
+    ASSERT_EQ(time, 1000 + 7321 * 10);
+    ASSERT_EQ(status, 73);
+    ASSERT_EQ(host, "host1");
+    it += -7000;
+    ASSERT_EQ(get<0>(*it), 1000 + 321 * 10);
+    ASSERT_EQ(get<1>(*it), 3);
+}
+
+TEST(Compressed, IteratorCopiesAreIndependent) {
+    vector<int> values(1000);
+    for (int i = 0; i < 1000; ++i)
+        values[i] = i * i;
+    delta_column column(values);
+    auto a = column.begin();
+    ASSERT_EQ(*a, 0);
+    auto b = a;
+    b += 900;
+    ASSERT_EQ(*b, 810000);
+    ASSERT_EQ(*a, 0);
+    a = b;
+    ASSERT_EQ(*++a, 901 * 901);
+    ASSERT_EQ(b[-899], 1);
+
+    // Перемещенный итератор распаковывает блок заново при следующем разыменовании.
+    auto c = move(b);
+    ASSERT_EQ(*c, 810000);
+    ASSERT_EQ(*b, 810000);
+    b = move(c);
+    ASSERT_EQ(*c, 810000);
+
+    delta_column<int> empty;
+    rle_column<int> empty_runs;
+    ASSERT_TRUE(empty.begin() == empty.end());
+    ASSERT_EQ(zip(empty, empty_runs).size(), 0u);
+}
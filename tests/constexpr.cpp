@@ -0,0 +1,77 @@
+#include <array>
+#include <tuple>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+using namespace zip_impl;
+
+/* Все проверки в этом файле выполняются на этапе компиляции: zip от std::array можно использовать
+ *  в константных выражениях для построения таблиц поиска.
+ */
+
+namespace {
+    constexpr array<int, 5> kKeys = {1, 2, 3, 4, 5};
+    constexpr array<int, 5> kWeights = {10, 20, 30, 40, 50};
+
+    constexpr array<int, 5> BuildTable() {
+        array<int, 5> table{};
+        for (const auto& [key, weight, cell] : zip(kKeys, kWeights, table))
+            cell = key * key + weight;
+        return table;
+    }
+
+    constexpr int SumWithStructuredBindings() {
+        int sum = 0;
+        const auto z = zip(kKeys, kWeights);
+        for (auto it = z.begin(); it != z.end(); ++it) {
+            const auto& [key, weight] = *it;
+            sum += key * weight;
+        }
+        return sum;
+    }
+
+    constexpr bool RandomAccess() {
+        auto z = zip(kKeys, kWeights);
+        auto it = z.begin() + 3;
+        auto back = z.end() - 1;
+        return get<1>(*it) == 40 && get<0>(it[1]) == 5 && it < back && back - z.begin() == 4 && z.size() == 5
+                && *--back == make_tuple(4, 40);
+    }
+
+    constexpr array<double, 3> kCoefficients = {0.5, 0.25, 0.125};
+    constexpr array<double, 4> kScales = {2.0, 4.0, 8.0, 16.0};
+
+    constexpr array<double, 3> Scaled() {
+        array<double, 3> result{};
+        for (const auto& [coefficient, scale, out] : zip(kCoefficients, kScales, result))
+            out = coefficient * scale;
+        return result;
+    }
+}
+
+TEST(Constexpr, TableFromZippedArrays) {
+    constexpr auto table = BuildTable();
+    static_assert(table[0] == 11);
+    static_assert(table[4] == 75);
+    ASSERT_EQ(table[2], 39);
+}
+
+TEST(Constexpr, IterationAndComparison) {
+    static_assert(SumWithStructuredBindings() == 550);
+    static_assert(RandomAccess());
+    static_assert(Scaled()[0] == 1.0 && Scaled()[1] == 1.0 && Scaled()[2] == 1.0);
+}
+
+TEST(Constexpr, TupleAndIterators) {
+    constexpr auto z = zip(kKeys, kWeights);
+    static_assert(z.begin() != z.end());
+    static_assert(z.size() == 5);
+    static_assert(z.slice(1, 3).size() == 2);
+    static_assert(*z.begin() == make_tuple(1, 10));
+    static_assert(get<1>(*(z.begin() + 2)) == 30);
+    static_assert(*z.begin() < *(z.begin() + 1));
+    constexpr IterRange<const int*> range(kKeys.data() + 1, kKeys.data() + 3);
+    static_assert(zip(range, kWeights).size() == 2);
+}
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+using namespace zip_impl;
+
+namespace {
+    template <typename Zip, typename Mask, typename = void>
+    struct CanFilter : public false_type {};
+
+    template <typename Zip, typename Mask>
+    struct CanFilter<Zip, Mask, void_t<decltype(declval<Zip>().filter_mask(declval<Mask>()))>> : public true_type {};
+}
+
+TEST(Filter, MakeMask) {
+    vector<int> a(130);
+    for (int i = 0; i < 130; ++i)
+        a[i] = i;
+    auto mask = make_mask(zip(a), [](const auto& row) { return get<0>(row) % 2 == 0 || get<0>(row) == 129; });
+    ASSERT_EQ(mask.size(), 3u);
+    ASSERT_EQ(mask[0], 0x5555555555555555ULL);
+    ASSERT_EQ(mask[1], 0x5555555555555555ULL);
+    ASSERT_EQ(mask[2], 0b11ULL);
+}
+
+TEST(Filter, FilterMaskVisitsSelectedRows) {
+    vector<int> a(200);
+    vector<string> b(200);
+    for (int i = 0; i < 200; ++i) {
+        a[i] = i;
+        b[i] = to_string(i);
+    }
+    auto z = zip(a, b);
+    auto mask = make_mask(z, [](const auto& row) { return get<0>(row) % 3 == 0; });
+
+    vector<int> obtained;
+    for (const auto& [number, text] : z.filter_mask(mask)) {
+        ASSERT_EQ(text, to_string(number));
+        obtained.push_back(number);
+        number = -number;
+    }
+    vector<int> expected;
+    for (int i = 0; i < 200; i += 3)
+        expected.push_back(i);
+    ASSERT_EQ(obtained, expected);
+    ASSERT_EQ(a[3], -3);
+    ASSERT_EQ(a[4], 4);
+
+    // Временная маска была бы уничтожена раньше представления.
+    static_assert(CanFilter<decltype(z)&, vector<uint64_t>&>::value);
+    static_assert(CanFilter<const decltype(z)&, const vector<uint64_t>&>::value);
+    static_assert(!CanFilter<decltype(z)&, decltype(mask)>::value);
+    static_assert(!CanFilter<const decltype(z)&, const vector<uint64_t>>::value);
+}
+
+TEST(Filter, MaskBitsBeyondRangeAreIgnored) {
+    vector<int> a = {1, 2, 3};
+    const vector<uint64_t> all(4, ~uint64_t{0});
+    int count = 0;
+    for (const auto& row : zip(a).filter_mask(all))
+        count += get<0>(row);
+    ASSERT_EQ(count, 6);
+
+    const vector<uint64_t> none(1, 0);
+    ASSERT_TRUE(zip(a).filter_mask(none).begin() == zip(a).filter_mask(none).end());
+    vector<int> empty;
+    ASSERT_TRUE(zip(empty).filter_mask(all).begin() == zip(empty).filter_mask(all).end());
+}
+
+TEST(Filter, CompactKeepsOrderAndMoves) {
+    vector<int> keys;
+    vector<unique_ptr<int>> payloads;
+    for (int i = 0; i < 150; ++i) {
+        keys.push_back(i);
+        payloads.push_back(make_unique<int>(i * 10));
+    }
+    auto z = zip(keys, payloads);
+    auto last = compact(z, [](const auto& row) { return get<0>(row) % 4 != 1; });
+    int kept = last - z.begin();
+    ASSERT_EQ(kept, 150 - 38);
+    int expected = 0;
+    for (int i = 0; i < kept; ++i, ++expected) {
+        if (expected % 4 == 1)
+            ++expected;
+        ASSERT_EQ(keys[i], expected);
+        ASSERT_EQ(*payloads[i], expected * 10);
+    }
+}
@@ -0,0 +1,86 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_generator.h"
+
+#if defined(ZIPCPP_HAS_GENERATOR)
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    generator<int> Numbers(int first, int last) {
+        for (int i = first; i < last; ++i)
+            co_yield i;
+    }
+
+    // Декодер, возвращающий значения страницами по page штук.
+    generator<long> Pages(long count, long page) {
+        vector<long> buffer;
+        for (long start = 0; start < count; start += page) {
+            buffer.clear();
+            for (long i = start; i < count && i < start + page; ++i)
+                buffer.push_back(i * i);
+            co_yield batch(buffer);
+            co_yield batch(buffer.data(), 0);
+        }
+    }
+
+    generator<string> Failing() {
+        co_yield string("ok");
+        throw runtime_error("decoder failed");
+    }
+}
+
+TEST(Generator, ZipWithContainer) {
+    auto numbers = Numbers(10, 100);
+    vector<string> names = {"a", "b", "c"};
+    string obtained;
+    for (const auto& [number, name] : zip(numbers, names))
+        obtained += name + to_string(number);
+    ASSERT_EQ(obtained, "a10b11c12");
+}
+
+TEST(Generator, ZipTwoGenerators) {
+    auto numbers = Numbers(0, 5);
+    auto squares = Pages(1000, 3);
+    vector<long> obtained;
+    for (const auto& [number, square] : zip(numbers, squares))
+        obtained.push_back(square - number);
+    ASSERT_EQ(obtained, (vector<long>{0, 0, 2, 6, 12}));
+}
+
+TEST(Generator, BatchYield) {
+    auto squares = Pages(10, 4);
+    vector<long> obtained;
+    for (long value : squares)
+        obtained.push_back(value);
+    ASSERT_EQ(obtained, (vector<long>{0, 1, 4, 9, 16, 25, 36, 49, 64, 81}));
+}
+
+TEST(Generator, FramesAreReused) {
+    { auto warmup = Numbers(0, 1); }
+    size_t cached = zip_impl::FramePool::Cached();
+    ASSERT_GE(cached, 1u);
+    {
+        auto numbers = Numbers(0, 3);
+        ASSERT_EQ(zip_impl::FramePool::Cached(), cached - 1);
+    }
+    ASSERT_EQ(zip_impl::FramePool::Cached(), cached);
+}
+
+TEST(Generator, ExceptionsPropagate) {
+    auto values = Failing();
+    auto it = values.begin();
+    ASSERT_EQ(*it, "ok");
+    ASSERT_THROW(++it, runtime_error);
+}
+
+TEST(Generator, Empty) {
+    auto numbers = Numbers(5, 5);
+    ASSERT_TRUE(numbers.begin() == numbers.end());
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_join.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(HashJoin, MatchesWithDuplicates) {
+    vector<int> a_keys = {1, 2, 3, 2};
+    vector<string> a_names = {"one", "two", "three", "deux"};
+    vector<long> b_keys = {2, 4, 1, 2, 2};
+    vector<double> b_values = {0.5, 4.0, 1.5, 2.5, 3.5};
+    auto za = zip(a_keys, a_names);
+    auto zb = zip(b_keys, b_values);
+
+    vector<tuple<string, double>> obtained;
+    hash_join<0, 0>(za, zb, [&](const auto& row_a, const auto& row_b) {
+        const auto& [key_a, name] = row_a;
+        const auto& [key_b, value] = row_b;
+        EXPECT_EQ(key_a, key_b);
+        obtained.emplace_back(name, value);
+    });
+    sort(obtained.begin(), obtained.end());
+
+    const vector<tuple<string, double>> expected = {
+        {"deux", 0.5}, {"deux", 2.5}, {"deux", 3.5},
+        {"one", 1.5},
+        {"two", 0.5}, {"two", 2.5}, {"two", 3.5},
+    };
+    ASSERT_EQ(obtained, expected);
+}
+
+TEST(HashJoin, ArgumentOrderDoesNotDependOnBuildSide) {
+    vector<int> small = {7, 8};
+    vector<int> large_keys = {8, 9, 7, 7, 10};
+    vector<char> large_tags = {'a', 'b', 'c', 'd', 'e'};
+    auto zs = zip(small);
+    auto zl = zip(large_tags, large_keys);
+
+    vector<pair<int, char>> first, second;
+    hash_join<0, 1>(zs, zl, [&](const auto& row_s, const auto& row_l) {
+        first.emplace_back(get<0>(row_s), get<0>(row_l));
+    });
+    hash_join<1, 0>(zl, zs, [&](const auto& row_l, const auto& row_s) {
+        second.emplace_back(get<0>(row_s), get<0>(row_l));
+    });
+    sort(first.begin(), first.end());
+    sort(second.begin(), second.end());
+
+    const vector<pair<int, char>> expected = {{7, 'c'}, {7, 'd'}, {8, 'a'}};
+    ASSERT_EQ(first, expected);
+    ASSERT_EQ(second, expected);
+}
+
+TEST(HashJoin, EmitsReferencesToColumns) {
+    vector<int> a_keys = {1, 2, 3};
+    vector<string> payload = {"x", "y", "z"};
+    const vector<int> b_keys = {3, 1};
+    auto za = zip(a_keys, payload);
+    auto zb = zip(b_keys);
+
+    size_t matches = 0;
+    hash_join<0, 0>(za, zb, [&](const auto& row_a, const auto& row_b) {
+        auto& name = get<1>(row_a);
+        ASSERT_GE(&name, payload.data());
+        ASSERT_LT(&name, payload.data() + payload.size());
+        name += "!";
+        ASSERT_EQ(&get<0>(row_b), &b_keys[get<0>(row_b) == 3 ? 0 : 1]);
+        ++matches;
+    });
+    ASSERT_EQ(matches, 2u);
+    ASSERT_EQ(payload, (vector<string>{"x!", "y", "z!"}));
+}
+
+TEST(HashJoin, EmptyAndUnequalColumns) {
+    vector<int> empty;
+    vector<int> keys = {1, 2, 3, 4};
+    vector<int> shorter = {10, 20};
+    size_t matches = 0;
+    auto count = [&](const auto&, const auto&) { ++matches; };
+
+    auto z_empty = zip(empty);
+    auto z_keys = zip(keys);
+    hash_join<0, 0>(z_empty, z_keys, count);
+    ASSERT_EQ(matches, 0u);
+
+    // Строки с ключами 3 и 4 не входят в zip(keys, shorter), так как второй столбец короче.
+    auto z_short = zip(keys, shorter);
+    vector<int> probe = {3, 4, 1};
+    auto z_probe = zip(probe);
+    hash_join<0, 0>(z_short, z_probe, count);
+    ASSERT_EQ(matches, 1u);
+}
+
+TEST(HashJoin, ParallelMatchesSerial) {
+    vector<int> a_keys, a_values, b_keys;
+    for (int i = 0; i < 5000; ++i) {
+        a_keys.push_back(i % 1300);
+        a_values.push_back(i);
+    }
+    for (int i = 0; i < 3000; ++i)
+        b_keys.push_back((i * 7) % 2000);
+    auto za = zip(a_keys, a_values);
+    auto zb = zip(b_keys);
+
+    vector<pair<int, int>> serial, parallel;
+    mutex guard;
+    hash_join<0, 0>(za, zb, [&](const auto& row_a, const auto& row_b) {
+        serial.emplace_back(get<1>(row_a), get<0>(row_b));
+    });
+    hash_join<0, 0>(za, zb, [&](const auto& row_a, const auto& row_b) {
+        lock_guard<mutex> lock(guard);
+        parallel.emplace_back(get<1>(row_a), get<0>(row_b));
+    }, 4);
+    sort(serial.begin(), serial.end());
+    sort(parallel.begin(), parallel.end());
+    ASSERT_FALSE(serial.empty());
+    ASSERT_EQ(serial, parallel);
+}
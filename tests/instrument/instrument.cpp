@@ -0,0 +1,89 @@
+// Эти тесты собираются в отдельную программу с определенным макросом ZIPCPP_INSTRUMENT,
+//  поскольку макрос должен быть одинаково определен во всех единицах трансляции.
+#include <algorithm>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    instrument::site_report Find(const char* name) {
+        auto sites = instrument::report();
+        auto found = find_if(sites.begin(), sites.end(), [name](const auto& site) { return string(site.name) == name; });
+        EXPECT_NE(found, sites.end());
+        return found != sites.end() ? *found : instrument::site_report{};
+    }
+}
+
+TEST(Instrument, CountsRangeForLoop) {
+    instrument::reset();
+    vector<int> a = {1, 2, 3};
+    string s = "abcdef";
+    {
+        ZIPCPP_LOOP("range-for");
+        for (const auto& [x, c] : zip(a, s)) {
+            (void)x;
+            (void)c;
+        }
+    }
+    auto site = Find("range-for");
+    EXPECT_EQ(site.loops, 1u);
+    EXPECT_EQ(site.totals.dereferences, 3u);
+    EXPECT_EQ(site.totals.advances, 3u);
+    EXPECT_EQ(site.totals.iterator_advances, 6u);
+    EXPECT_EQ(site.totals.comparisons, 4u);
+}
+
+TEST(Instrument, NestedZipCountsInnerOperations) {
+    instrument::reset();
+    list<int> a = {1, 2};
+    list<int> b = {3, 4};
+    vector<int> c = {5, 6};
+    auto inner = zip(a, b);
+    {
+        ZIPCPP_LOOP("nested");
+        for (const auto& [pair, value] : zip(inner, c)) {
+            (void)pair;
+            (void)value;
+        }
+    }
+    auto site = Find("nested");
+    // Каждое разыменование внешнего итератора разыменовывает и внутренний.
+    EXPECT_EQ(site.totals.dereferences, 4u);
+    EXPECT_EQ(site.totals.advances, 4u);
+}
+
+TEST(Instrument, ScopesArePerThreadAndAccumulate) {
+    instrument::reset();
+    vector<int> a(100, 1);
+    auto work = [&a] {
+        ZIPCPP_LOOP("threads");
+        int sum = 0;
+        for (const auto& [x] : zip(a))
+            sum += x;
+        EXPECT_EQ(sum, 100);
+    };
+    thread first(work), second(work);
+    first.join();
+    second.join();
+    auto site = Find("threads");
+    EXPECT_EQ(site.loops, 2u);
+    EXPECT_EQ(site.totals.dereferences, 200u);
+}
+
+TEST(Instrument, UnscopedOperations) {
+    instrument::reset();
+    vector<int> a = {1, 2};
+    auto z = zip(a);
+    auto it = z.begin();
+    ++it;
+    *it;
+    auto site = Find("<unscoped>");
+    EXPECT_EQ(site.totals.advances, 1u);
+    EXPECT_EQ(site.totals.dereferences, 1u);
+}
@@ -0,0 +1,137 @@
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_interleave.h"
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    struct Point3 {
+        float x, y, z;
+    };
+
+    struct Point2d {
+        double x, y;
+    };
+
+    struct Color {
+        int32_t r, g, b, a;
+    };
+
+    struct Pair16 {
+        uint16_t key, value;
+    };
+
+    struct Mixed {
+        int64_t id;
+        int32_t count;
+        float weight;
+    };
+
+    template <typename Record, typename F>
+    vector<Record> MakeRecords(size_t count, F&& make) {
+        vector<Record> records;
+        for (size_t i = 0; i < count; ++i)
+            records.push_back(make(i));
+        return records;
+    }
+}
+
+TEST(Interleave, Float3RoundTrip) {
+    // 11 записей: векторная часть и скалярный остаток.
+    auto points = MakeRecords<Point3>(11, [](size_t i) {
+        return Point3{float(i), float(i) + 0.5f, -float(i)};
+    });
+    vector<float> xs = {100.0f}, ys = {100.0f}, zs = {100.0f};
+    ASSERT_EQ(deinterleave(points, xs, ys, zs), 11u);
+    ASSERT_EQ(xs.size(), 12u);
+    for (size_t i = 0; i < points.size(); ++i) {
+        ASSERT_EQ(xs[i + 1], points[i].x);
+        ASSERT_EQ(ys[i + 1], points[i].y);
+        ASSERT_EQ(zs[i + 1], points[i].z);
+    }
+
+    vector<Point3> restored;
+    ASSERT_EQ(interleave(zip(xs, ys, zs).slice(1, 12), restored), 11u);
+    for (size_t i = 0; i < points.size(); ++i) {
+        ASSERT_EQ(restored[i].x, points[i].x);
+        ASSERT_EQ(restored[i].y, points[i].y);
+        ASSERT_EQ(restored[i].z, points[i].z);
+    }
+}
+
+TEST(Interleave, DoubleAndIntegerLayouts) {
+    auto points = MakeRecords<Point2d>(5, [](size_t i) { return Point2d{double(i), double(i * i)}; });
+    vector<double> xs, ys;
+    deinterleave(points, xs, ys);
+    ASSERT_EQ(xs, (vector<double>{0, 1, 2, 3, 4}));
+    ASSERT_EQ(ys, (vector<double>{0, 1, 4, 9, 16}));
+
+    auto colors = MakeRecords<Color>(9, [](size_t i) {
+        int32_t v = static_cast<int32_t>(i);
+        return Color{v, v + 100, v + 200, -v};
+    });
+    vector<int32_t> r, g, b, a;
+    deinterleave(colors, r, g, b, a);
+    ASSERT_EQ(g[8], 108);
+    ASSERT_EQ(a[7], -7);
+    vector<Color> restored(2);
+    interleave(zip(r, g, b, a), restored);
+    ASSERT_EQ(restored.size(), 11u);
+    ASSERT_EQ(restored[10].b, 208);
+    ASSERT_EQ(restored[2].r, 0);
+
+    auto pairs = MakeRecords<Pair16>(7, [](size_t i) { return Pair16{uint16_t(i), uint16_t(1000 + i)}; });
+    vector<uint16_t> keys, values;
+    deinterleave(pairs, keys, values);
+    ASSERT_EQ(keys[6], 6);
+    ASSERT_EQ(values[6], 1006);
+}
+
+TEST(Interleave, Double3And4) {
+    struct Point3d { double x, y, z; };
+    struct Point4d { double x, y, z, w; };
+    auto points = MakeRecords<Point3d>(5, [](size_t i) { return Point3d{double(i), -double(i), 0.5 * i}; });
+    vector<double> xs, ys, zs;
+    deinterleave(points, xs, ys, zs);
+    ASSERT_EQ(ys, (vector<double>{0, -1, -2, -3, -4}));
+    ASSERT_EQ(zs[3], 1.5);
+    vector<Point3d> restored;
+    interleave(zip(xs, ys, zs), restored);
+    ASSERT_EQ(restored[4].x, 4.0);
+    ASSERT_EQ(restored[4].y, -4.0);
+    ASSERT_EQ(restored[4].z, 2.0);
+
+    auto quads = MakeRecords<Point4d>(3, [](size_t i) { return Point4d{double(i), 1.0 + i, 2.0 + i, 3.0 + i}; });
+    vector<double> a, b, c, d;
+    deinterleave(quads, a, b, c, d);
+    ASSERT_EQ(d, (vector<double>{3, 4, 5}));
+    vector<Point4d> restored4;
+    interleave(zip(a, b, c, d), restored4);
+    ASSERT_EQ(restored4[1].z, 3.0);
+    ASSERT_EQ(restored4[2].w, 5.0);
+}
+
+TEST(Interleave, MixedFieldsAndGenericContainers) {
+    auto records = MakeRecords<Mixed>(4, [](size_t i) {
+        return Mixed{int64_t(i) << 40, int32_t(i * 3), float(i) / 2};
+    });
+    deque<int64_t> ids;
+    list<int32_t> counts;
+    vector<float> weights;
+    deinterleave(records, ids, counts, weights);
+    ASSERT_EQ(ids[3], int64_t(3) << 40);
+    ASSERT_EQ(counts.back(), 9);
+    ASSERT_EQ(weights[1], 0.5f);
+
+    array<Mixed, 2> out{};
+    ASSERT_EQ(interleave(zip(ids, counts, weights), out), 2u);
+    ASSERT_EQ(out[1].id, int64_t(1) << 40);
+    ASSERT_EQ(out[1].count, 3);
+    ASSERT_EQ(out[1].weight, 0.5f);
+}
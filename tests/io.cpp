@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <deque>
+#include <fcntl.h>
+#include <list>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_io.h"
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    string TempPath(const string& name) {
+        return testing::TempDir() + "zipcpp_" + name + "_" + to_string(getpid()) + ".bin";
+    }
+}
+
+TEST(WriteColumns, ContiguousRoundTrip) {
+    vector<int> ids = {1, 2, 3, 4, 5};
+    vector<double> prices = {1.5, 2.5, 3.5, 4.5, 5.5};
+    vector<char> flags = {'a', 'b', 'c', 'd', 'e'};
+    string path = TempPath("contiguous");
+    size_t written = write_columns(path, zip(ids, prices, flags));
+
+    column_file file(path);
+    ASSERT_EQ(file.size(), 5u);
+    ASSERT_EQ(file.columns(), 3u);
+    auto read_ids = file.column<int>(0);
+    auto read_prices = file.column<double>(1);
+    ASSERT_EQ(vector<int>(read_ids.begin(), read_ids.end()), ids);
+    ASSERT_EQ(vector<double>(read_prices.begin(), read_prices.end()), prices);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(read_prices.begin()) % 64, 0u);
+
+    string obtained;
+    for (const auto& [id, price, flag] : file.as_zip<int, double, char>())
+        obtained += to_string(id) + flag + to_string(static_cast<int>(price)) + " ";
+    ASSERT_EQ(obtained, "1a1 2b2 3c3 4d4 5e5 ");
+    struct stat status {};
+    ASSERT_EQ(stat(path.c_str(), &status), 0);
+    ASSERT_EQ(written, static_cast<size_t>(status.st_size));
+    unlink(path.c_str());
+}
+
+TEST(WriteColumns, StagedColumnsMatchContiguous) {
+    // Строк больше, чем помещается в промежуточные буферы, чтобы столбцы записывались несколькими частями.
+    const size_t rows = 200000;
+    list<int64_t> a;
+    deque<float> b;
+    vector<bool> c;
+    vector<int64_t> expected_a;
+    for (size_t i = 0; i < rows; ++i) {
+        a.push_back(static_cast<int64_t>(i) * 3);
+        b.push_back(static_cast<float>(i) / 2);
+        c.push_back(i % 3 == 0);
+        expected_a.push_back(static_cast<int64_t>(i) * 3);
+    }
+    string path = TempPath("staged");
+    write_columns(path, zip(a, b, c));
+
+    column_file file(path);
+    ASSERT_EQ(file.size(), rows);
+    auto read_a = file.column<int64_t>(0);
+    ASSERT_EQ(vector<int64_t>(read_a.begin(), read_a.end()), expected_a);
+    size_t index = 0;
+    bool same = true;
+    for (const auto& [x, y, z] : file.as_zip<int64_t, float, bool>()) {
+        same = same && x == expected_a[index] && y == b[index] && z == c[index];
+        ++index;
+    }
+    ASSERT_TRUE(same);
+    ASSERT_EQ(index, rows);
+    unlink(path.c_str());
+}
+
+TEST(WriteColumns, FileDescriptorAndEmptyZip) {
+    vector<short> empty;
+    list<unsigned> other;
+    string path = TempPath("empty");
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    write_columns(fd, zip(empty, other));
+    close(fd);
+
+    column_file file(path);
+    ASSERT_EQ(file.size(), 0u);
+    ASSERT_EQ(file.columns(), 2u);
+    auto rows = file.as_zip<short, unsigned>();
+    ASSERT_TRUE(rows.begin() == rows.end());
+    unlink(path.c_str());
+}
+
+TEST(WriteColumns, TypeMismatch) {
+    vector<int> ids = {1, 2};
+    vector<float> values = {1, 2};
+    string path = TempPath("mismatch");
+    write_columns(path, zip(ids, values));
+
+    column_file file(path);
+    ASSERT_THROW(file.column<unsigned>(0), invalid_argument);
+    ASSERT_THROW(file.column<int>(1), invalid_argument);
+    ASSERT_THROW(file.column<int>(2), out_of_range);
+    ASSERT_THROW(column_file(TempPath("missing")), system_error);
+    unlink(path.c_str());
+}
+
+TEST(WriteColumns, CorruptHeader) {
+    vector<int> ids = {1, 2, 3};
+    string path = TempPath("corrupt");
+    write_columns(path, zip(ids));
+    // Поля заголовка: columns по смещению 12, rows - 16; offset первого столбца - 32.
+    auto patch = [&path](off_t offset, auto value) {
+        int fd = open(path.c_str(), O_WRONLY);
+        ASSERT_EQ(pwrite(fd, &value, sizeof(value), offset), static_cast<ssize_t>(sizeof(value)));
+        close(fd);
+    };
+
+    patch(12, uint32_t{0xFFFFFFFF});
+    ASSERT_THROW(column_file{path}, runtime_error);
+    patch(12, uint32_t{1});
+    // Произведение количества строк на размер значения переполняется до нуля.
+    patch(16, uint64_t{1} << 62);
+    ASSERT_THROW(column_file{path}, runtime_error);
+    patch(16, uint64_t{3});
+    patch(32, uint64_t{65});
+    ASSERT_THROW(column_file{path}, runtime_error);
+    patch(32, uint64_t{64});
+    ASSERT_EQ(column_file(path).size(), 3u);
+
+    ASSERT_EQ(truncate(path.c_str(), 30), 0);
+    ASSERT_THROW(column_file{path}, runtime_error);
+    unlink(path.c_str());
+}
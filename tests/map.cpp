@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(Map, Accumulate) {
+    vector<double> prices = {1.5, 2.0, 4.0};
+    vector<int> amounts = {2, 3, 1};
+    auto totals = zip(prices, amounts).map([](const auto& row) {
+        auto [price, amount] = row;
+        return price * amount;
+    });
+    ASSERT_DOUBLE_EQ(accumulate(totals.begin(), totals.end(), 0.0), 13.0);
+    ASSERT_EQ(totals.size(), 3u);
+    ASSERT_DOUBLE_EQ(totals.begin()[1], 6.0);
+}
+
+TEST(Map, MaxElementKeepsRandomAccess) {
+    vector<int> a = {3, 9, 4};
+    vector<int> b = {5, 1, 7};
+    auto sums = zip(a, b).map([](const auto& row) { return get<0>(row) + get<1>(row); });
+    static_assert(is_same_v<decltype(sums.begin())::iterator_category, random_access_iterator_tag>);
+    auto best = max_element(sums.begin(), sums.end());
+    ASSERT_EQ(best - sums.begin(), 2);
+    ASSERT_EQ(*best, 11);
+    ASSERT_TRUE(is_sorted(sums.begin(), sums.begin() + 2));
+}
+
+TEST(Map, FusedChain) {
+    vector<int> a = {1, 2, 3};
+    vector<int> b = {10, 20, 30};
+    auto first = zip(a, b).map([](const auto& row) { return get<0>(row) * get<1>(row); });
+    auto chained = first.map([](int x) { return x + 1; }).map([](int x) { return to_string(x); });
+    // Итераторы цепочки обходят итераторы исходного объекта Zip, а не вложенных представлений.
+    static_assert(is_same_v<decay_t<decltype(chained.begin().base())>, decltype(zip(a, b).begin())>);
+    ASSERT_EQ(vector<string>(chained.begin(), chained.end()), (vector<string>{"11", "41", "91"}));
+
+    auto same = transform_view(first, [](int x) { return -x; });
+    static_assert(is_same_v<decay_t<decltype(same.begin().base())>, decltype(zip(a, b).begin())>);
+    ASSERT_EQ(*same.begin(), -10);
+}
+
+TEST(Map, ReferencesAndConst) {
+    vector<int> a = {1, 2, 3};
+    vector<string> names = {"x", "y", "z"};
+    auto refs = zip(a, names).map([](auto row) -> int& { return get<0>(row); });
+    for (int& value : refs)
+        value *= 10;
+    ASSERT_EQ(a, (vector<int>{10, 20, 30}));
+
+    const auto rows = zip(a, names);
+    auto labels = rows.map([](const auto& row) { return get<1>(row) + to_string(get<0>(row)); });
+    ASSERT_EQ(*(labels.end() - 1), "z30");
+}
+
+TEST(Map, TransformViewOverContainers) {
+    list<int> values = {1, 2, 3};
+    auto squares = transform_view(values, [](int x) { return x * x; });
+    ASSERT_EQ(accumulate(squares.begin(), squares.end(), 0), 14);
+    ASSERT_EQ(squares.size(), 3u);
+}
+
+TEST(Map, ParallelChunks) {
+    vector<long> a(1000), b(1000);
+    iota(a.begin(), a.end(), 0);
+    iota(b.begin(), b.end(), 1);
+    auto products = zip(a, b).map([](const auto& row) { return get<0>(row) * get<1>(row); });
+    auto chunks = products.chunks(300);
+    ASSERT_EQ(chunks.size(), 4u);
+    atomic<long> total{0};
+    vector<thread> workers;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        workers.emplace_back([&, i] {
+            auto chunk = chunks[i];
+            total += accumulate(chunk.begin(), chunk.end(), 0L);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    ASSERT_EQ(total.load(), accumulate(products.begin(), products.end(), 0L));
+    ASSERT_EQ(products.slice(10, 12).size(), 2u);
+}
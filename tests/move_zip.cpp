@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+using namespace zip_impl;
+
+namespace {
+    vector<unique_ptr<int>> MakePointers(int count) {
+        vector<unique_ptr<int>> result;
+        for (int i = 0; i < count; ++i)
+            result.push_back(make_unique<int>(i));
+        return result;
+    }
+}
+
+TEST(MoveZip, DereferenceYieldsRvalueReferences) {
+    vector<string> a = {"a"};
+    vector<int> b = {1};
+    auto m = move_zip(a, b);
+    auto row = *m.begin();
+    static_assert(is_same_v<decltype(row), Tuple<string&&, int&&>>);
+    static_assert(is_same_v<decltype(get<0>(row)), string&&>);
+
+    auto z = zip(a, b);
+    static_assert(is_same_v<decltype(iter_move(z.begin())), Tuple<string&&, int&&>>);
+}
+
+TEST(MoveZip, CopyIntoZipMovesElements) {
+    auto pointers = MakePointers(3);
+    vector<string> names = {"first", "second", "third"};
+    vector<unique_ptr<int>> out_pointers(3);
+    vector<string> out_names(3);
+
+    auto m = move_zip(pointers, names);
+    auto out = zip(out_pointers, out_names);
+    std::copy(m.begin(), m.end(), out.begin());
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(pointers[i], nullptr);
+        ASSERT_EQ(*out_pointers[i], i);
+    }
+    ASSERT_EQ(out_names, (vector<string>{"first", "second", "third"}));
+}
+
+TEST(MoveZip, BackInserterMovesIntoTuples) {
+    auto pointers = MakePointers(4);
+    vector<string> names(4, string(100, 'x'));
+    vector<tuple<unique_ptr<int>, string>> rows;
+
+    auto m = zip(pointers, names).moving();
+    std::copy(m.begin(), m.end(), back_inserter(rows));
+
+    ASSERT_EQ(rows.size(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(pointers[i], nullptr);
+        ASSERT_EQ(*get<0>(rows[i]), i);
+        ASSERT_EQ(get<1>(rows[i]), string(100, 'x'));
+    }
+}
+
+TEST(MoveZip, StructuredBindingsAndIterMove) {
+    auto pointers = MakePointers(2);
+    vector<int> keys = {10, 20};
+    vector<unique_ptr<int>> moved;
+    for (auto&& [pointer, key] : move_zip(pointers, keys)) {
+        moved.push_back(std::forward<decltype(pointer)>(pointer));
+        ASSERT_EQ(key, 10 * static_cast<int>(moved.size()));
+    }
+    ASSERT_EQ(pointers[1], nullptr);
+    ASSERT_EQ(*moved[1], 1);
+
+    auto more = MakePointers(1);
+    auto z = zip(more, keys);
+    tuple<unique_ptr<int>, int> row = iter_move(z.begin());
+    ASSERT_EQ(more[0], nullptr);
+    ASSERT_EQ(*get<0>(row), 0);
+}
+
+TEST(MoveZip, ConstColumnsAreCopied) {
+    const vector<string> names = {"kept"};
+    vector<string> out(1);
+    auto m = move_zip(names);
+    auto target = zip(out);
+    std::copy(m.begin(), m.end(), target.begin());
+    ASSERT_EQ(names[0], "kept");
+    ASSERT_EQ(out[0], "kept");
+}
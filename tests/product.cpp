@@ -0,0 +1,140 @@
+#include <atomic>
+#include <list>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_product.h"
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    // Крупные элементы, чтобы плитки были небольшими и тесты перебирали несколько плиток без больших векторов.
+    struct Wide {
+        long value = 0;
+        char padding[248] = {};
+    };
+
+    vector<Wide> Iota(size_t size, long first = 0) {
+        vector<Wide> values(size);
+        for (size_t i = 0; i < size; ++i)
+            values[i].value = first + static_cast<long>(i);
+        return values;
+    }
+}
+
+TEST(Product, SmallRangesInNestedLoopOrder) {
+    vector<int> a = {1, 2, 3};
+    vector<string> b = {"x", "y"};
+    string obtained;
+    for (const auto& [number, name] : product(a, b))
+        obtained += name + to_string(number);
+    ASSERT_EQ(obtained, "x1y1x2y2x3y3");
+    ASSERT_EQ(product(a, b).size(), 6u);
+}
+
+TEST(Product, Modify) {
+    vector<int> a = {1, 2, 3};
+    vector<int> b = {10, 20};
+    vector<int> sums(a.size() * b.size());
+    auto out = sums.begin();
+    for (auto [x, y] : product(a, b))
+        *out++ = x + y;
+    ASSERT_EQ(sums, (vector<int>{11, 21, 12, 22, 13, 23}));
+
+    for (auto [x, y] : product(a, b))
+        x += y;
+    ASSERT_EQ(a, (vector<int>{31, 32, 33}));
+}
+
+TEST(Product, ForwardRanges) {
+    list<int> a = {1, 2};
+    vector<char> b = {'a', 'b', 'c'};
+    list<int> c = {7};
+    ASSERT_FALSE(decltype(product(a, b, c))::tiled);
+    string obtained;
+    for (const auto& [x, y, z] : product(a, b, c))
+        obtained += to_string(x) + y + to_string(z) + " ";
+    ASSERT_EQ(obtained, "1a7 1b7 1c7 2a7 2b7 2c7 ");
+}
+
+TEST(Product, Empty) {
+    vector<int> a = {1, 2, 3};
+    vector<double> b;
+    auto rows = product(a, b);
+    ASSERT_EQ(rows.size(), 0u);
+    ASSERT_EQ(rows.tiles(), 0u);
+    ASSERT_TRUE(rows.begin() == rows.end());
+}
+
+TEST(Product, TiledTraversalVisitsEveryPairOnce) {
+    vector<Wide> a = Iota(150), b = Iota(130);
+    auto rows = product(a, b);
+    ASSERT_TRUE(decltype(rows)::tiled);
+    ASSERT_LT(rows.tile_size(0), a.size());
+    ASSERT_LT(rows.tile_size(1), b.size());
+
+    vector<char> seen(a.size() * b.size(), 0);
+    size_t count = 0;
+    bool lexicographic = true;
+    long previous = -1;
+    for (const auto& [x, y] : rows) {
+        long key = x.value * static_cast<long>(b.size()) + y.value;
+        lexicographic = lexicographic && key > previous;
+        previous = key;
+        ++seen[key];
+        ++count;
+    }
+    ASSERT_EQ(count, rows.size());
+    ASSERT_TRUE(all_of(seen.begin(), seen.end(), [](char c) { return c == 1; }));
+    ASSERT_FALSE(lexicographic);
+}
+
+TEST(Product, TilesPartitionRows) {
+    vector<Wide> a = Iota(100, 1), b = Iota(90, 1), c = Iota(3, 1);
+    auto rows = product(a, b, c);
+    ASSERT_GT(rows.tiles(), 1u);
+    size_t count = 0;
+    long sum = 0;
+    for (size_t index = 0; index < rows.tiles(); ++index) {
+        for (const auto& [x, y, z] : rows.tile(index)) {
+            ++count;
+            sum += x.value * y.value * z.value;
+        }
+    }
+    ASSERT_EQ(count, rows.size());
+    ASSERT_EQ(sum, (100L * 101 / 2) * (90L * 91 / 2) * 6);
+}
+
+TEST(Product, ParallelTiles) {
+    vector<Wide> a = Iota(200), b = Iota(300, 1);
+    auto rows = product(a, b);
+    atomic<size_t> count{0};
+    atomic<long> sum{0};
+    for_each_tile_parallel(rows, 4, [&](const auto& row) {
+        const auto& [x, y] = row;
+        count.fetch_add(1, memory_order_relaxed);
+        if (x.value == 0)
+            sum.fetch_add(y.value, memory_order_relaxed);
+    });
+    ASSERT_EQ(count.load(), a.size() * b.size());
+    ASSERT_EQ(sum.load(), 300L * 301 / 2);
+}
+
+TEST(Product, ForEachTile) {
+    vector<Wide> a = Iota(100), b = Iota(90);
+    vector<char> seen(a.size() * b.size(), 0);
+    for_each_tile(product(a, b), [&](const auto& row) {
+        const auto& [x, y] = row;
+        ++seen[x.value * b.size() + y.value];
+    });
+    ASSERT_TRUE(all_of(seen.begin(), seen.end(), [](char c) { return c == 1; }));
+
+    for_each_tile(product(a, b), [](const auto& row) {
+        auto [x, y] = row;
+        if (y.value == 0)
+            x.value = -x.value;
+    });
+    ASSERT_EQ(a[5].value, -5);
+}
@@ -0,0 +1,102 @@
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+using namespace zip_impl;
+
+TEST(ProxyReference, ReadAndWriteBits) {
+    vector<bool> flags = {true, false, true};
+    vector<int> values = {1, 2, 3};
+    int sum = 0;
+    for (const auto& [flag, value] : zip(flags, values)) {
+        if (flag)
+            sum += value;
+    }
+    ASSERT_EQ(sum, 4);
+
+    for (auto&& [flag, value] : zip(flags, values))
+        flag = value > 1;
+    ASSERT_EQ(flags, (vector<bool>{false, true, true}));
+
+    auto z = zip(flags, values);
+    zip_impl::swap(*z.begin(), *(z.begin() + 1));
+    ASSERT_EQ(flags, (vector<bool>{true, false, true}));
+    ASSERT_EQ(values, (vector<int>{2, 1, 3}));
+}
+
+TEST(ProxyReference, ConstBitsAreCopied) {
+    const vector<bool> flags = {true, false};
+    const vector<string> names = {"a", "b"};
+    for (const auto& [flag, name] : zip(flags, names)) {
+        static_assert(is_same_v<decltype(flag), const bool>);
+        static_assert(is_same_v<decltype(name), const string&>);
+        ASSERT_EQ(flag, name == "a");
+    }
+}
+
+TEST(ForEachRow, BitBlocksMatchRowByRow) {
+    vector<bool> flags;
+    vector<long> values;
+    for (int i = 0; i < 1000; ++i) {
+        flags.push_back(i % 3 == 0 || i % 7 == 0);
+        values.push_back(i);
+    }
+    // Биты константного вектора нельзя изменить через строки, поэтому они читаются машинными словами.
+    const vector<bool>& const_flags = flags;
+    auto z = zip(const_flags, values);
+    // Срезы начинаются с разных позиций внутри машинного слова и имеют длину, не кратную размеру блока.
+    for (size_t first : {0, 1, 5, 63, 64, 130}) {
+        for (size_t last : {first, first + 1, first + 64, first + 200, size_t{1000}}) {
+            long expected = 0;
+            for (size_t i = first; i < last; ++i)
+                expected += flags[i] ? values[i] : -values[i];
+            long obtained = 0;
+            size_t rows = 0;
+            for_each_row(z.slice(first, last), [&](const auto& row) {
+                const auto& [flag, value] = row;
+                obtained += flag ? value : -value;
+                ++rows;
+            });
+            ASSERT_EQ(obtained, expected) << first << " " << last;
+            ASSERT_EQ(rows, last - first);
+        }
+    }
+}
+
+TEST(ForEachRow, WritableBits) {
+    vector<bool> flags(200, false);
+    vector<long> values(200);
+    for (long i = 0; i < 200; ++i)
+        values[i] = i;
+    auto z = zip(flags, values);
+    static_assert(!UsesBitBlocks<decltype(z.begin())>::value);
+    for_each_row(z, [](auto&& row) {
+        auto&& [flag, value] = row;
+        flag = value % 3 == 0;
+    });
+    for (size_t i = 0; i < flags.size(); ++i)
+        ASSERT_EQ(flags[i], i % 3 == 0) << i;
+
+    // Строки константного объекта Zip читаются блоками, и элементы остальных столбцов передаются константными ссылками.
+    const auto& cz = z;
+    long sum = 0;
+    for_each_row(cz, [&sum](auto&& row) {
+        static_assert(is_const_v<remove_reference_t<decltype(get<1>(row))>>);
+        sum += get<0>(row) ? get<1>(row) : 0;
+    });
+    ASSERT_EQ(sum, 3 * (66 * 67 / 2));
+}
+
+TEST(ForEachRow, GenericColumns) {
+    vector<int> a = {1, 2, 3};
+    vector<string> b = {"x", "y", "z"};
+    for_each_row(zip(a, b), [](auto&& row) {
+        auto&& [number, text] = row;
+        text += to_string(number);
+    });
+    ASSERT_EQ(b, (vector<string>{"x1", "y2", "z3"}));
+}
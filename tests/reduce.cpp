@@ -0,0 +1,124 @@
+#include <cmath>
+#include <list>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_reduce.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(GroupBy, SortedKeys) {
+    vector<int> keys = {1, 1, 2, 5, 5, 5};
+    vector<string> names = {"a", "b", "c", "d", "e", "f"};
+    auto z = zip(keys, names);
+
+    vector<int> group_keys;
+    vector<string> group_names;
+    for (const auto& [key, rows] : group_by<0>(z)) {
+        group_keys.push_back(key);
+        string joined;
+        for (const auto& [k, name] : rows) {
+            EXPECT_EQ(k, key);
+            joined += name;
+        }
+        group_names.push_back(joined);
+    }
+    ASSERT_EQ(group_keys, (vector<int>{1, 2, 5}));
+    ASSERT_EQ(group_names, (vector<string>{"ab", "c", "def"}));
+}
+
+TEST(GroupBy, SubrangesReferToColumns) {
+    vector<int> keys = {3, 3, 4};
+    vector<int> values = {0, 0, 0};
+    auto z = zip(keys, values);
+    for (auto [key, rows] : group_by<0>(z)) {
+        for (const auto& [k, value] : rows)
+            value = key * 10;
+    }
+    ASSERT_EQ(values, (vector<int>{30, 30, 40}));
+}
+
+TEST(GroupBy, LongSegmentsAndUnequalColumns) {
+    // Длинные группы проверяют блочный поиск границы, а более короткий второй столбец - выравнивание конца.
+    vector<long> keys;
+    for (long key = 0; key < 5; ++key)
+        keys.insert(keys.end(), 37 * (key + 1), key);
+    vector<char> flags(keys.size() - 10, 'x');
+    auto z = zip(keys, flags);
+
+    vector<size_t> lengths;
+    for (const auto& [key, rows] : group_by<0>(z))
+        lengths.push_back(rows.size());
+    ASSERT_EQ(lengths, (vector<size_t>{37, 74, 111, 148, 175}));
+}
+
+TEST(GroupBy, NodeBasedAndEmpty) {
+    list<string> keys = {"x", "x", "y", "x"};
+    const vector<int> values = {1, 2, 3, 4};
+    size_t groups = 0;
+    for (const auto& [key, rows] : group_by<0>(zip(keys, values))) {
+        ++groups;
+        for (const auto& [k, value] : rows)
+            EXPECT_EQ(k, key);
+    }
+    ASSERT_EQ(groups, 3u);
+
+    vector<int> empty;
+    auto z = zip(empty);
+    auto range = group_by<0>(z);
+    ASSERT_TRUE(range.begin() == range.end());
+}
+
+TEST(SegmentedReduce, AllAggregatesInOnePass) {
+    const vector<int> keys = {1, 1, 1, 2, 3, 3};
+    const vector<double> prices = {1.5, 0.5, 2.0, 7.0, 3.0, 1.0};
+    const vector<int> volumes = {10, 30, 20, 5, 1, 2};
+    auto z = zip(keys, prices, volumes);
+
+    vector<tuple<int, double, double, int, size_t>> obtained;
+    for (const auto& [key, total, cheapest, largest, count] :
+            segmented_reduce<0>(z, sum_of<1>{}, min_of<1>{}, max_of<2>{}, row_count{})) {
+        obtained.emplace_back(key, total, cheapest, largest, count);
+    }
+    const vector<tuple<int, double, double, int, size_t>> expected = {
+        {1, 4.0, 0.5, 30, 3},
+        {2, 7.0, 7.0, 5, 1},
+        {3, 4.0, 1.0, 2, 2},
+    };
+    ASSERT_EQ(obtained, expected);
+}
+
+TEST(SegmentedReduce, GenericKeyColumn) {
+    list<string> keys = {"a", "a", "b"};
+    vector<int> values = {4, 6, 1};
+    vector<pair<string, int>> obtained;
+    for (const auto& [key, total] : segmented_reduce<0>(zip(keys, values), sum_of<1>{}))
+        obtained.emplace_back(key, total);
+    ASSERT_EQ(obtained, (vector<pair<string, int>>{{"a", 10}, {"b", 1}}));
+}
+
+TEST(SegmentedReduce, NanKeysFormSingleRowGroups) {
+    // NaN не равен себе, поэтому каждая строка с ключом NaN - отдельная группа из одной строки.
+    const vector<double> keys = {1.0, NAN, NAN, 2.0};
+    const vector<int> values = {1, 2, 3, 4};
+    auto z = zip(keys, values);
+
+    vector<size_t> lengths;
+    for (const auto& [key, rows] : group_by<0>(z)) {
+        lengths.push_back(rows.size());
+        if (lengths.size() > keys.size())
+            break;
+    }
+    ASSERT_EQ(lengths, (vector<size_t>{1, 1, 1, 1}));
+
+    vector<int> totals;
+    for (const auto& [key, total] : segmented_reduce<0>(z, sum_of<1>{})) {
+        totals.push_back(total);
+        if (totals.size() > keys.size())
+            break;
+    }
+    ASSERT_EQ(totals, (vector<int>{1, 2, 3, 4}));
+}
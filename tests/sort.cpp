@@ -0,0 +1,147 @@
+#include <cstdint>
+#include <cstdlib>
+#include <dirent.h>
+#include <list>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_sort.h"
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    // Каталог для временных файлов одного теста; удаляется деструктором.
+    class TempDirectory {
+    public:
+        TempDirectory() {
+            string pattern = testing::TempDir() + "zipcpp_sort_XXXXXX";
+            path_ = mkdtemp(pattern.data());
+        }
+
+        ~TempDirectory() { rmdir(path_.c_str()); }
+
+        const string& path() const { return path_; }
+
+        size_t Files() const {
+            size_t count = 0;
+            DIR* dir = opendir(path_.c_str());
+            while (dirent* entry = readdir(dir))
+                count += entry->d_name[0] != '.';
+            closedir(dir);
+            return count;
+        }
+
+    private:
+        string path_;
+    };
+}
+
+TEST(ExternalSort, InMemory) {
+    vector<int> keys = {5, 3, 5, 1, 3};
+    vector<double> values = {0.5, 0.3, 0.6, 0.1, 0.4};
+    vector<int> sorted_keys;
+    vector<double> sorted_values;
+    size_t rows = external_sort_by<0>(zip(keys, values), [&](const auto& row) {
+        auto [key, value] = row;
+        sorted_keys.push_back(key);
+        sorted_values.push_back(value);
+    }, 1 << 20);
+    ASSERT_EQ(rows, 5u);
+    ASSERT_EQ(sorted_keys, (vector<int>{1, 3, 3, 5, 5}));
+    ASSERT_EQ(sorted_values, (vector<double>{0.1, 0.3, 0.4, 0.5, 0.6}));
+}
+
+TEST(ExternalSort, SpilledRunsAreMergedStably) {
+    const uint32_t rows = 20000;
+    mt19937 random(7);
+    vector<int32_t> keys(rows);
+    vector<uint32_t> positions(rows);
+    for (uint32_t i = 0; i < rows; ++i) {
+        keys[i] = static_cast<int32_t>(random() % 1000) - 500;
+        positions[i] = i;
+    }
+
+    TempDirectory directory;
+    vector<int32_t> sorted_keys;
+    bool stable = true;
+    uint32_t previous = 0;
+    // 16 КБ - около 500 строк в части, то есть несколько десятков серий.
+    size_t count = external_sort_by<0>(zip(keys, positions), [&](const auto& row) {
+        const auto& [key, position] = row;
+        if (!sorted_keys.empty() && sorted_keys.back() == key)
+            stable = stable && previous < position;
+        sorted_keys.push_back(key);
+        previous = position;
+    }, 16 << 10, directory.path());
+
+    ASSERT_EQ(count, rows);
+    ASSERT_TRUE(stable);
+    vector<int32_t> expected = keys;
+    sort(expected.begin(), expected.end());
+    ASSERT_EQ(sorted_keys, expected);
+    ASSERT_EQ(directory.Files(), 0u);
+}
+
+TEST(ExternalSort, ForwardRowsBySecondColumn) {
+    list<uint64_t> ids;
+    vector<uint64_t> scores;
+    for (uint64_t i = 0; i < 3000; ++i) {
+        ids.push_back(i);
+        scores.push_back((i * 7919) % 3001);
+    }
+    TempDirectory directory;
+    vector<uint64_t> sorted_scores;
+    uint64_t id_sum = 0;
+    external_sort_by<1>(zip(ids, scores), [&](const auto& row) {
+        id_sum += get<0>(row);
+        sorted_scores.push_back(get<1>(row));
+    }, 8 << 10, directory.path());
+    ASSERT_EQ(id_sum, 2999u * 3000 / 2);
+    ASSERT_TRUE(is_sorted(sorted_scores.begin(), sorted_scores.end()));
+    ASSERT_EQ(sorted_scores.size(), 3000u);
+}
+
+TEST(ExternalSort, EmptyInputAndMissingDirectory) {
+    vector<int> keys;
+    size_t calls = 0;
+    ASSERT_EQ(external_sort_by<0>(zip(keys), [&](const auto&) { ++calls; }, 1024), 0u);
+    ASSERT_EQ(calls, 0u);
+
+    vector<int> many(1000, 1);
+    ASSERT_THROW(external_sort_by<0>(zip(many), [](const auto&) {}, 64, "/nonexistent/zipcpp"), system_error);
+}
+
+TEST(ExternalSort, ChunkMultipleInput) {
+    // Бюджет 24 * 100 байтов - ровно 100 строк int32_t и uint32_t в части.
+    const size_t budget = 2 * (2 * sizeof(uint32_t) + sizeof(uint32_t)) * 100;
+    vector<int32_t> keys(100);
+    vector<uint32_t> positions(100);
+    for (uint32_t i = 0; i < 100; ++i) {
+        keys[i] = static_cast<int32_t>((i * 37) % 10);
+        positions[i] = i;
+    }
+    // Строки помещаются в одну часть, поэтому временные файлы не создаются и каталог не используется.
+    size_t calls = 0;
+    ASSERT_EQ(external_sort_by<0>(zip(keys, positions), [&](const auto&) { ++calls; }, budget, "/nonexistent/zipcpp"), 100u);
+    ASSERT_EQ(calls, 100u);
+
+    // Две полные части: последняя записывается после окончания строк.
+    keys.insert(keys.end(), keys.begin(), keys.end());
+    for (uint32_t i = 100; i < 200; ++i)
+        positions.push_back(i);
+    TempDirectory directory;
+    vector<pair<int32_t, uint32_t>> sorted;
+    external_sort_by<0>(zip(keys, positions), [&](const auto& row) {
+        sorted.emplace_back(get<0>(row), get<1>(row));
+    }, budget, directory.path());
+    vector<pair<int32_t, uint32_t>> expected;
+    for (uint32_t i = 0; i < 200; ++i)
+        expected.emplace_back(keys[i], i);
+    stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    ASSERT_EQ(sorted, expected);
+    ASSERT_EQ(directory.Files(), 0u);
+}
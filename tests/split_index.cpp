@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(SplitIndex, BalancedPartsCoverAllRows) {
+    for (size_t rows : {0, 1, 3, 100, 1000, 12345}) {
+        list<int> a;
+        for (size_t i = 0; i < rows; ++i)
+            a.push_back(static_cast<int>(i));
+        auto z = zip(a);
+        for (size_t parts : {1, 2, 3, 8}) {
+            auto index = split_index(z, parts);
+            ASSERT_EQ(index.size(), parts);
+            ASSERT_EQ(index.rows(), rows);
+            vector<int> obtained;
+            for (size_t part = 0; part < index.size(); ++part) {
+                size_t size = 0;
+                for (const auto& [value] : index[part]) {
+                    obtained.push_back(value);
+                    ++size;
+                }
+                ASSERT_EQ(size, index.part_size(part));
+                // Отклонение длины части от средней ограничено шагом между запомненными точками.
+                ASSERT_LE(size, rows / parts + rows / (8 * parts) + 2);
+                ASSERT_GE(size + rows / (8 * parts) + 2, rows / parts);
+            }
+            ASSERT_EQ(obtained, vector<int>(a.begin(), a.end()));
+        }
+    }
+}
+
+TEST(SplitIndex, ParallelScansOfNodeContainers) {
+    set<int> keys;
+    list<long> values;
+    for (int i = 0; i < 5000; ++i) {
+        keys.insert(i * 2);
+        values.push_back(i);
+    }
+    auto index = split_index(zip(keys, values), 4);
+
+    for (int scan = 0; scan < 3; ++scan) {
+        vector<long> sums(index.size());
+        vector<thread> workers;
+        for (size_t part = 0; part < index.size(); ++part) {
+            workers.emplace_back([&, part] {
+                for (const auto& [key, value] : index[part])
+                    sums[part] += key + value;
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        long total = 0;
+        for (long sum : sums)
+            total += sum;
+        ASSERT_EQ(total, 5000L * 4999 / 2 * 3);
+    }
+
+    size_t parts = 0;
+    for (const auto& part : index.parts())
+        parts += part.begin() != part.end();
+    ASSERT_EQ(parts, 4u);
+}
+
+TEST(SplitIndex, InvalidateAndRebuild) {
+    map<int, string> names = {{1, "a"}, {2, "b"}};
+    list<int> counts = {10, 20};
+    auto index = split_index(zip(names, counts), 2);
+    ASSERT_TRUE(index.valid());
+    ASSERT_EQ(index.rows(), 2u);
+
+    names.emplace(0, "z");
+    counts.push_front(5);
+    index.invalidate();
+    ASSERT_FALSE(index.valid());
+    // Начало контейнеров изменилось, поэтому индекс перестраивается для нового объекта Zip.
+    index.rebuild(zip(names, counts));
+    ASSERT_TRUE(index.valid());
+    ASSERT_EQ(index.rows(), 3u);
+    vector<string> obtained;
+    for (const auto& part : index.parts())
+        for (const auto& [name, count] : part)
+            obtained.push_back(name.second + to_string(count));
+    ASSERT_EQ(obtained, (vector<string>{"z5", "a10", "b20"}));
+}
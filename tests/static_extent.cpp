@@ -0,0 +1,80 @@
+#include <array>
+#include <list>
+#include <numeric>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(StaticExtent, StaticSize) {
+    int c_array[4] = {};
+    array<double, 3> std_array = {};
+    const array<char, 8> const_array = {};
+    vector<int> v(2);
+
+    static_assert(decltype(zip(c_array, std_array))::static_size == 3);
+    static_assert(decltype(zip(const_array, c_array))::static_size == 4);
+    static_assert(decltype(zip(std_array))::static_size == 3);
+    static_assert(decltype(zip(c_array, v))::static_size == dynamic_extent);
+    static_assert(decltype(zip(v))::static_size == dynamic_extent);
+    static_assert(decltype(zip())::static_size == 0);
+
+    auto inner = zip(c_array, const_array);
+    static_assert(decltype(zip(inner, std_array))::static_size == 3);
+    ASSERT_EQ(zip(c_array, std_array).size(), decltype(zip(c_array, std_array))::static_size);
+}
+
+TEST(StaticExtent, ForEachStatic) {
+    array<int, 4> a = {1, 2, 3, 4};
+    int b[5] = {10, 20, 30, 40, 50};
+    int sum = 0;
+    for_each_static(zip(a, b), [&sum](const auto& row) {
+        const auto& [x, y] = row;
+        sum += x * y;
+    });
+    ASSERT_EQ(sum, 300);
+
+    for_each_static(zip(a, b), [](const auto& row) {
+        const auto& [x, y] = row;
+        x += y;
+    });
+    ASSERT_EQ(a, (array<int, 4>{11, 22, 33, 44}));
+}
+
+TEST(StaticExtent, ForEachStaticLongRange) {
+    // Длина больше предела разворачивания: используется цикл с постоянным числом итераций.
+    array<long, 100> a;
+    array<long, 120> b;
+    iota(a.begin(), a.end(), 0);
+    b.fill(2);
+    long sum = 0;
+    for_each_static(zip(a, b), [&sum](const auto& row) { sum += get<0>(row) * get<1>(row); });
+    ASSERT_EQ(sum, 9900);
+}
+
+namespace {
+    constexpr array<int, 3> kLeft = {1, 2, 3};
+    constexpr array<int, 3> kRight = {4, 5, 6};
+
+    constexpr int Dot() {
+        int result = 0;
+        for_each_static(zip(kLeft, kRight), [&result](const auto& row) { result += get<0>(row) * get<1>(row); });
+        return result;
+    }
+}
+
+TEST(StaticExtent, ForEachStaticConstexpr) {
+    static_assert(Dot() == 32);
+}
+
+#if defined(__cpp_lib_span)
+TEST(StaticExtent, Span) {
+    array<int, 6> data = {};
+    span<int, 4> fixed(data.data(), 4);
+    span<int> dynamic(data);
+    static_assert(decltype(zip(fixed, data))::static_size == 4);
+    static_assert(decltype(zip(fixed, dynamic))::static_size == dynamic_extent);
+}
+#endif
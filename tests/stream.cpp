@@ -0,0 +1,124 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_stream.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(Stream, SingleThread) {
+    spsc_stream<int> stream(8);
+    ASSERT_EQ(stream.capacity(), 8u);
+    for (int i = 0; i < 5; ++i)
+        ASSERT_TRUE(stream.push(i));
+    stream.close();
+    vector<int> obtained;
+    for (int value : stream)
+        obtained.push_back(value);
+    ASSERT_EQ(obtained, (vector<int>{0, 1, 2, 3, 4}));
+    ASSERT_FALSE(stream.push(5));
+}
+
+TEST(Stream, Empty) {
+    spsc_stream<string> stream;
+    stream.close();
+    ASSERT_TRUE(stream.begin() == stream.end());
+}
+
+TEST(Stream, TryPush) {
+    spsc_stream<int> stream(2);
+    ASSERT_TRUE(stream.try_push(1));
+    ASSERT_TRUE(stream.try_push(2));
+    ASSERT_FALSE(stream.try_push(3));
+    auto it = stream.begin();
+    ASSERT_EQ(*it, 1);
+    ++it;
+    ASSERT_TRUE(stream.try_push(3));
+}
+
+TEST(Stream, ZipProducers) {
+    constexpr int kRows = 100000;
+    spsc_stream<long> prices(64);
+    spsc_stream<int> quotes(16);
+    thread price_producer([&] {
+        for (int i = 0; i < kRows; ++i)
+            prices.push(i * 3L);
+        prices.close();
+    });
+    thread quote_producer([&] {
+        for (int i = 0; i < kRows + 10; ++i)
+            quotes.push(i);
+        quotes.close();
+    });
+
+    long rows = 0;
+    bool ordered = true;
+    for (const auto& [price, quote] : zip(prices, quotes)) {
+        ordered = ordered && price == 3L * rows && quote == rows;
+        ++rows;
+    }
+    price_producer.join();
+    quotes.close();
+    quote_producer.join();
+
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(rows, kRows);
+}
+
+TEST(Stream, ConsumerCloseReleasesProducer) {
+    spsc_stream<int> stream(4);
+    bool rejected = false;
+    thread producer([&] {
+        for (int i = 0; i < 1000; ++i) {
+            if (!stream.push(i)) {
+                rejected = true;
+                break;
+            }
+        }
+    });
+    auto it = stream.begin();
+    ASSERT_EQ(*it, 0);
+    stream.close();
+    producer.join();
+    ASSERT_TRUE(rejected);
+}
+
+TEST(Stream, MoveOnly) {
+    spsc_stream<unique_ptr<int>> stream(4);
+    vector<int> values = {7, 8, 9};
+    thread producer([&] {
+        for (int value : values)
+            stream.push(make_unique<int>(value));
+        stream.push(make_unique<int>(0));
+        stream.close();
+    });
+    vector<int> obtained;
+    for (auto&& [pointer, value] : zip(stream, values))
+        obtained.push_back(*pointer + value);
+    producer.join();
+    ASSERT_EQ(obtained, (vector<int>{14, 16, 18}));
+}
+
+TEST(Stream, PingPong) {
+    // Каждое значение ждет ответа, поэтому потерянное пробуждение привело бы к зависанию теста.
+    spsc_stream<int> requests(8), responses(8);
+    thread worker([&] {
+        for (int value : requests)
+            responses.push(value + 1);
+        responses.close();
+    });
+    spsc_stream<int>::iterator it;
+    for (int i = 0; i < 2000; ++i) {
+        requests.push(i);
+        if (i == 0)
+            it = responses.begin();
+        else
+            ++it;
+        EXPECT_EQ(*it, i + 1);
+    }
+    requests.close();
+    worker.join();
+}
@@ -0,0 +1,89 @@
+#include <deque>
+#include <list>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_unzip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(Unzip, TuplesIntoVectors) {
+    const vector<tuple<int, string, double>> rows = {{1, "one", 1.5}, {2, "two", 2.5}, {3, "three", 3.5}};
+    vector<int> ids = {0};
+    vector<string> names;
+    vector<double> values;
+    ASSERT_EQ(unzip(rows, ids, names, values), 3u);
+    ASSERT_EQ(ids, (vector<int>{0, 1, 2, 3}));
+    ASSERT_EQ(names, (vector<string>{"one", "two", "three"}));
+    ASSERT_EQ(values, (vector<double>{1.5, 2.5, 3.5}));
+}
+
+TEST(Unzip, PairsIntoArbitraryContainers) {
+    const list<pair<char, int>> rows = {{'a', 1}, {'b', 2}};
+    deque<char> keys;
+    list<int> values;
+    unzip(rows, keys, values);
+    ASSERT_EQ(keys, (deque<char>{'a', 'b'}));
+    ASSERT_EQ(values, (list<int>{1, 2}));
+}
+
+TEST(Unzip, SelectedElements) {
+    const vector<tuple<int, string, double>> rows = {{1, "one", 1.5}, {2, "two", 2.5}};
+    vector<double> values;
+    vector<int> ids;
+    unzip_into<2, 0>(rows, values, ids);
+    ASSERT_EQ(values, (vector<double>{1.5, 2.5}));
+    ASSERT_EQ(ids, (vector<int>{1, 2}));
+}
+
+TEST(Unzip, ZipRoundTripAndUnsizedSource) {
+    const list<pair<string, int>> pairs = {{"x", 1}, {"y", 2}};
+    vector<string> keys;
+    vector<int> values;
+    // У IterRange нет метода size(), а итераторы list двунаправленные, поэтому длина источника заранее неизвестна.
+    ASSERT_EQ(unzip(IterRange(pairs.begin(), pairs.end()), keys, values), 2u);
+    ASSERT_EQ(keys, (vector<string>{"x", "y"}));
+    ASSERT_EQ(values, (vector<int>{1, 2}));
+
+    vector<int> a = {1, 2, 3};
+    list<string> b = {"x", "y", "z", "w"};
+    vector<int> a2;
+    vector<string> b2;
+    ASSERT_EQ(unzip(zip(a, b), a2, b2), 3u);
+    ASSERT_EQ(a2, a);
+    ASSERT_EQ(b2, (vector<string>{"x", "y", "z"}));
+}
+
+TEST(Unzip, MoveZipSourceMovesValues) {
+    vector<string> names(3, string(50, 'n'));
+    vector<int> ids = {1, 2, 3};
+    vector<string> out_names;
+    vector<int> out_ids;
+    unzip(move_zip(names, ids), out_names, out_ids);
+    ASSERT_EQ(out_names, vector<string>(3, string(50, 'n')));
+    ASSERT_EQ(out_ids, ids);
+    for (const auto& name : names)
+        ASSERT_TRUE(name.empty());
+}
+
+TEST(Unzip, ParallelMatchesSerial) {
+    vector<tuple<long, float, string>> rows;
+    for (long i = 0; i < 10007; ++i)
+        rows.emplace_back(i * 3, static_cast<float>(i) / 2, to_string(i));
+    vector<long> a1 = {-1}, a2 = {-1};
+    vector<float> b1, b2;
+    vector<string> c1, c2;
+    unzip(rows, a1, b1, c1);
+    ASSERT_EQ(unzip_parallel(rows, 4, a2, b2, c2), rows.size());
+    ASSERT_EQ(a1, a2);
+    ASSERT_EQ(b1, b2);
+    ASSERT_EQ(c1, c2);
+
+    vector<float> b3;
+    unzip_into_parallel<1>(rows, 3, b3);
+    ASSERT_EQ(b1, b3);
+}
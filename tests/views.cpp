@@ -0,0 +1,174 @@
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+namespace {
+    template <typename Zip, typename Indices, typename = void>
+    struct CanTake : public false_type {};
+
+    template <typename Zip, typename Indices>
+    struct CanTake<Zip, Indices, void_t<decltype(declval<Zip>().take(declval<Indices>()))>> : public true_type {};
+}
+
+TEST(Views, Slice) {
+    vector<int> a = {0, 1, 2, 3, 4, 5};
+    string s = "abcd";
+    auto z = zip(a, s);
+
+    auto middle = z.slice(1, 3);
+    static_assert(is_same_v<decltype(middle), decltype(z)>);
+    string obtained;
+    for (const auto& [number, letter] : middle)
+        obtained += to_string(number) + letter;
+    ASSERT_EQ(obtained, "1b2c");
+
+    // Границы ограничиваются длиной самого короткого контейнера.
+    ASSERT_EQ(z.slice(2, 100).size(), 2u);
+    ASSERT_EQ(z.slice(10, 20).size(), 0u);
+    ASSERT_EQ(z.slice(3, 1).size(), 0u);
+
+    const auto& cz = z;
+    for (const auto& [number, letter] : cz.slice(0, 1)) {
+        static_assert(is_const_v<remove_reference_t<decltype(number)>>);
+        ASSERT_EQ(letter, 'a');
+    }
+}
+
+TEST(Views, Chunks) {
+    vector<int> a(10);
+    iota(a.begin(), a.end(), 0);
+    vector<int> b(10, 1);
+    auto z = zip(a, b);
+
+    auto chunks = z.chunks(4);
+    ASSERT_EQ(chunks.size(), 3u);
+    ASSERT_EQ(chunks.end() - chunks.begin(), 3);
+    vector<size_t> sizes;
+    for (const auto& chunk : chunks)
+        sizes.push_back(chunk.size());
+    ASSERT_EQ(sizes, (vector<size_t>{4, 4, 2}));
+    auto [first_a, first_b] = chunks[2].begin().AsTuple();
+    ASSERT_EQ(first_a, a.begin() + 8);
+    ASSERT_EQ(first_b, b.begin() + 8);
+    ASSERT_EQ(z.chunks(5).size(), 2u);
+}
+
+TEST(Views, ChunksInThreads) {
+    vector<long> values(1000);
+    iota(values.begin(), values.end(), 1);
+    vector<long> squares(values.size());
+    auto z = zip(values, squares);
+
+    vector<thread> workers;
+    for (auto chunk : z.chunks(128)) {
+        workers.emplace_back([chunk]() mutable {
+            for (const auto& [value, square] : chunk)
+                square = value * value;
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    for (size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(squares[i], values[i] * values[i]);
+}
+
+TEST(Views, Stride) {
+    vector<int> a = {0, 1, 2, 3, 4, 5, 6};
+    vector<char> b = {'a', 'b', 'c', 'd', 'e', 'f', 'g'};
+    auto z = zip(a, b);
+
+    string obtained;
+    for (const auto& [number, letter] : z.stride(3)) {
+        obtained += letter;
+        number = -number;
+    }
+    ASSERT_EQ(obtained, "adg");
+    ASSERT_EQ(a, (vector<int>{0, 1, 2, -3, 4, 5, -6}));
+
+    auto every_second = z.stride(2);
+    ASSERT_EQ(every_second.size(), 4u);
+    auto it = every_second.begin();
+    it += 2;
+    ASSERT_EQ(get<1>(*it), 'e');
+    ASSERT_EQ(get<1>(it[1]), 'g');
+    ASSERT_EQ(every_second.end() - it, 2);
+    ASSERT_EQ(z.stride(10).size(), 1u);
+}
+
+TEST(Views, StrideOfEmpty) {
+    vector<int> empty;
+    auto z = zip(empty);
+    ASSERT_EQ(z.stride(2).size(), 0u);
+    ASSERT_EQ(z.chunks(2).size(), 0u);
+    ASSERT_TRUE(z.stride(2).begin() == z.stride(2).end());
+}
+
+TEST(Views, ZeroChunkOrStride) {
+    vector<int> a = {1, 2, 3};
+    auto z = zip(a);
+    ASSERT_THROW(z.chunks(0), invalid_argument);
+    ASSERT_THROW(z.stride(0), invalid_argument);
+    ASSERT_THROW(as_const(z).chunks(0), invalid_argument);
+}
+
+TEST(Views, Take) {
+    vector<int> a = {0, 10, 20, 30, 40};
+    deque<string> b = {"a", "b", "c", "d", "e"};
+    auto z = zip(a, b);
+    const vector<uint32_t> selection = {4, 1, 1, 3};
+
+    string obtained;
+    for (const auto& [number, letter] : z.take(selection)) {
+        obtained += letter;
+        number += 1;
+    }
+    ASSERT_EQ(obtained, "ebbd");
+    ASSERT_EQ(a, (vector<int>{0, 12, 20, 31, 41}));
+
+    auto taken = z.take(selection);
+    ASSERT_EQ(taken.size(), 4u);
+    ASSERT_EQ(get<1>(taken[3]), "d");
+
+    const auto& cz = z;
+    for (const auto& [number, letter] : cz.take(selection))
+        static_assert(is_const_v<remove_reference_t<decltype(number)>>);
+
+    // Временный контейнер номеров строк был бы уничтожен раньше представления.
+    static_assert(CanTake<decltype(z)&, vector<uint32_t>&>::value);
+    static_assert(CanTake<const decltype(z)&, const vector<uint32_t>&>::value);
+    static_assert(!CanTake<decltype(z)&, vector<uint32_t>>::value);
+    static_assert(!CanTake<const decltype(z)&, const vector<uint32_t>>::value);
+}
+
+TEST(Views, TakeManyRows) {
+    vector<long> keys(100000);
+    iota(keys.begin(), keys.end(), 0);
+    vector<double> values(keys.size(), 0.5);
+    vector<uint32_t> selection;
+    for (uint32_t i = 0; i < 5000; ++i)
+        selection.push_back((i * 7919u) % static_cast<uint32_t>(keys.size()));
+
+    long expected = 0;
+    for (uint32_t row : selection)
+        expected += keys[row];
+    long obtained = 0;
+    double weight = 0;
+    for (const auto& [key, value] : zip(keys, values).take(selection)) {
+        obtained += key;
+        weight += value;
+    }
+    ASSERT_EQ(obtained, expected);
+    ASSERT_EQ(weight, 2500.0);
+}
@@ -1,5 +1,6 @@
 #include <vector>
 #include <set>
+#include <string>
 #include "gtest/gtest.h"
 #include "zip.h"
 
@@ -147,3 +148,49 @@ TEST(Zip, ConstEndMethod) {
     }
 }
 
+
+TEST(Zip, SizeMethod) {
+    {
+        vector<int> a = {10, 20, 30};
+        const string s = "abcde";
+        ASSERT_EQ(zip(a, s).size(), 3u);
+        ASSERT_EQ(zip(s).size(), 5u);
+    }
+    {
+        set<int> s = {1, 2};
+        const char c[16] = {'h'};
+        const auto z = zip(c, s);
+        ASSERT_EQ(z.size(), 2u);
+    }
+    {
+        vector<int> a;
+        vector<int> b = {1};
+        ASSERT_EQ(zip(a, b).size(), 0u);
+    }
+}
+
+TEST(Zip, SubrangeMethod) {
+    vector<int> a = {10, 20, 30, 40};
+    const vector<char> b = {'a', 'b', 'c', 'd'};
+    auto z = zip(a, b);
+    auto sub = z.subrange(z.begin() + 1, z.begin() + 3);
+    static_assert(is_same_v<decltype(sub), decltype(z)>);
+    ASSERT_EQ(sub.size(), 2u);
+    auto [a_it, b_it] = sub.begin().AsTuple();
+    ASSERT_EQ(a_it, a.begin() + 1);
+    ASSERT_EQ(b_it, b.begin() + 1);
+
+    const auto& cz = z;
+    static_assert(is_same_v<decltype(cz.subrange(cz.begin(), cz.end()).begin()), typename decltype(z)::const_iterator>);
+    ASSERT_EQ(cz.subrange(cz.begin(), cz.begin() + 1).size(), 1u);
+}
+
+TEST(Zip, ContiguousIterators) {
+    static_assert(IsContiguousIterator<int*>::value);
+    static_assert(IsContiguousIterator<vector<int>::const_iterator>::value);
+    static_assert(IsContiguousIterator<string::iterator>::value);
+    static_assert(IsContiguousIterator<vector<char>::iterator>::value);
+    static_assert(IsContiguousIterator<u16string::const_iterator>::value);
+    static_assert(!IsContiguousIterator<vector<bool>::iterator>::value);
+    static_assert(!IsContiguousIterator<set<int>::iterator>::value);
+}
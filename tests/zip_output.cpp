@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "zip.h"
+#include "zip_unzip.h"
+
+using namespace std;
+using namespace zipcpp;
+
+TEST(ZipOutput, CopyIntoBackInserters) {
+    const vector<pair<int, string>> rows = {{1, "a"}, {2, "b"}, {3, "c"}};
+    vector<int> ids;
+    deque<string> names;
+    std::copy(rows.begin(), rows.end(), zip_output(back_inserter(ids), back_inserter(names)));
+    ASSERT_EQ(ids, (vector<int>{1, 2, 3}));
+    ASSERT_EQ(names, (deque<string>{"a", "b", "c"}));
+}
+
+TEST(ZipOutput, TransformIntoMixedIterators) {
+    vector<int> a = {1, 2, 3};
+    vector<int> b = {10, 20, 30};
+    int sums[3] = {};
+    ostringstream products;
+    auto z = zip(a, b);
+    auto out = std::transform(z.begin(), z.end(), zip_output(sums, ostream_iterator<int>(products, " ")),
+                              [](const auto& row) {
+                                  const auto& [x, y] = row;
+                                  return make_tuple(x + y, x * y);
+                              });
+    ASSERT_EQ(std::get<0>(out.AsTuple()), sums + 3);
+    ASSERT_EQ(vector<int>(sums, sums + 3), (vector<int>{11, 22, 33}));
+    ASSERT_EQ(products.str(), "10 40 90 ");
+}
+
+TEST(ZipOutput, ExplicitIncrementAndZipRows) {
+    vector<int> a = {5, 6};
+    vector<char> b = {'x', 'y'};
+    vector<int> a2;
+    vector<char> b2;
+    auto out = zip_output(back_inserter(a2), back_inserter(b2));
+    for (const auto& row : zip(a, b))
+        *out++ = row;
+    ASSERT_EQ(a2, a);
+    ASSERT_EQ(b2, b);
+}
+
+TEST(ZipOutput, PostIncrementIntoArrays) {
+    int a[3] = {};
+    char b[3] = {};
+    auto out = zip_output(a, b);
+    *out++ = make_tuple(1, 'x');
+    *out++ = make_tuple(2, 'y');
+    *out++ = make_tuple(3, 'z');
+    ASSERT_EQ(vector<int>(a, a + 3), (vector<int>{1, 2, 3}));
+    ASSERT_EQ(string(b, b + 3), "xyz");
+    ASSERT_EQ(std::get<0>(out.AsTuple()), a + 3);
+}
+
+TEST(ZipBackInserter, ReservesAllColumnsTogether) {
+    vector<long> ids = {-1};
+    vector<string> names;
+    deque<double> values;
+    auto out = zip_back_inserter(ids, names, values);
+    *out++ = make_tuple(0L, string("zero"), 0.0);
+    ASSERT_GE(ids.capacity(), 17u);
+    ASSERT_GE(names.capacity(), 16u);
+
+    for (long i = 1; i < 1000; ++i)
+        *out++ = make_tuple(i, to_string(i), i / 2.0);
+    ASSERT_EQ(ids.size(), 1001u);
+    ASSERT_EQ(names.size(), 1000u);
+    ASSERT_EQ(values.size(), 1000u);
+    ASSERT_EQ(ids[1000], 999);
+    ASSERT_EQ(names[999], "999");
+    ASSERT_EQ(values[999], 499.5);
+}
+
+TEST(ZipBackInserter, ExplicitReserve) {
+    vector<int> a;
+    vector<int> b;
+    auto out = zip_back_inserter(a, b);
+    out.reserve(500);
+    ASSERT_GE(a.capacity(), 500u);
+    ASSERT_GE(b.capacity(), 500u);
+    const int* data = a.data();
+    vector<pair<int, int>> rows;
+    for (int i = 0; i < 500; ++i)
+        rows.emplace_back(i, -i);
+    std::copy(rows.begin(), rows.end(), out);
+    ASSERT_EQ(a.data(), data);
+    ASSERT_EQ(b[499], -499);
+}
@@ -1,13 +1,47 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
-
-namespace zip_impl {
+#include <vector>
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+
+#if defined(ZIPCPP_INSTRUMENT)
+#include "zip_instrument.h"
+// Начиная с C++20 счетчики не мешают вычислению итераторов на этапе компиляции.
+#if defined(__cpp_lib_is_constant_evaluated)
+#define ZIPCPP_COUNT(counter, n) (std::is_constant_evaluated() ? void() : void(::zip_impl::instrument::Current().counter += (n)))
+#else
+#define ZIPCPP_COUNT(counter, n) (::zip_impl::instrument::Current().counter += (n))
+#endif
+#else
+#define ZIPCPP_COUNT(counter, n) ((void)0)
+#define ZIPCPP_LOOP(name) ((void)0)
+#endif
+
+// В интерфейсе модуля zipcpp (module/zipcpp.cppm) макрос определяется как export.
+#ifndef ZIPCPP_EXPORT
+#define ZIPCPP_EXPORT
+#endif
+
+ZIPCPP_EXPORT namespace zip_impl {
 
     template<typename...>
     class ZipIterator;
     template<typename...>
     class ConstZipIterator;
+    template<typename...>
+    class Zip;
 
     template <typename ... Elements>
     class Tuple;
@@ -20,8 +54,10 @@ namespace zip_impl {
 
     template <typename ... Elements>
     struct Tuple {
+        // Элементы - ссылки на элементы контейнеров, вложенные кортежи Zip или значения, возвращаемые итераторами
+        //  контейнеров с прокси-ссылками (например, std::vector<bool>::reference или bool для константного обхода).
         static_assert(std::conjunction_v<
-                std::disjunction< std::is_reference<Elements>, IsZipTuple<Elements> >...
+                std::disjunction< std::is_reference<Elements>, IsZipTuple<Elements>, std::is_object<Elements> >...
         >);
 
         using Base = std::tuple<Elements...>;
@@ -29,50 +65,205 @@ namespace zip_impl {
 
         Tuple(const Tuple&) = default;
         Tuple(Tuple&&) noexcept = default;
-        Tuple(const Base& b) : base(b) {}
-        Tuple(Base&& b) noexcept : base(std::move(b)) {}
+        constexpr Tuple(const Base& b) : base(b) {}
+        constexpr Tuple(Base&& b) noexcept : base(std::move(b)) {}
         template <typename ... UElements, typename = std::enable_if<std::conjunction_v<std::is_constructible<Elements, UElements>...>, int>>
-        explicit Tuple(UElements&&... elem) : base(std::forward<UElements>(elem)...) {}
+        constexpr explicit Tuple(UElements&&... elem) : base(std::forward<UElements>(elem)...) {}
 
         Tuple& operator=(Tuple&&) noexcept = default;
         Tuple& operator=(const Tuple&) = default;
         template <typename U>
-        Tuple& operator=(U&& other) {
+        constexpr Tuple& operator=(U&& other) {
             base = std::forward<U>(other);
             return *this;
         }
+        // Присваивание строки с другими типами ссылок, например, строки move_zip: элементы, на которые ссылаются
+        //  rvalue-ссылки, перемещаются.
+        template <typename ... Others>
+        constexpr Tuple& operator=(Tuple<Others...>&& other) {
+            base = std::move(other.base);
+            return *this;
+        }
+        template <typename ... Others>
+        constexpr Tuple& operator=(const Tuple<Others...>& other) {
+            base = other.base;
+            return *this;
+        }
+
+        // Копия значений строки, например, для вставки в std::vector<std::tuple<...>>. Значения, на которые
+        //  ссылаются rvalue-ссылки, перемещаются.
+        template <typename ... Values, typename = std::enable_if_t<sizeof...(Values) == sizeof...(Elements)
+                && std::conjunction_v<std::is_constructible<Values, Elements>...>>>
+        constexpr operator std::tuple<Values...>() const {
+            return ToTuple<Values...>(std::index_sequence_for<Elements...>{});
+        }
 
-        void swap(Tuple& other) {
+        constexpr void swap(Tuple& other) {
             using std::swap;
             swap(base, other.base);
         }
 
+        // Для элементов-rvalue-ссылок возвращается rvalue-ссылка, чтобы значения можно было переместить.
+        // Прокси-ссылки возвращаются по значению: их копия ссылается на тот же элемент и допускает присваивание.
         template <size_t Index>
-        auto& get() const {
-            return std::get<Index>(base);
+        constexpr decltype(auto) get() const {
+            using Element = std::tuple_element_t<Index, Base>;
+            if constexpr (std::is_rvalue_reference_v<Element>)
+                return static_cast<Element>(std::get<Index>(base));
+            else if constexpr (!std::is_reference_v<Element> && !IsZipTuple<Element>::value)
+                return Element(std::get<Index>(base));
+            else
+                return std::get<Index>(base);
         }
 
         //operator const Base&() const { return base; }
+    private:
+        template <typename ... Values, size_t... Indexes>
+        constexpr std::tuple<Values...> ToTuple(std::index_sequence<Indexes...>) const {
+            return std::tuple<Values...>(get<Indexes>()...);
+        }
     };
 
+    inline void Prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void)address;
+#endif
+    }
+
+    // std::hash для целых чисел обычно является тождественным отображением,
+    //  а таблица с открытой адресацией использует младшие биты хеша, поэтому биты перемешиваются.
+    inline size_t MixHash(size_t hash) {
+        uint64_t x = hash;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+
+    inline size_t HashCombine(size_t seed, size_t hash) {
+        return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    template <typename... Elements, size_t... Indexes>
+    size_t HashTuple(const Tuple<Elements...>& tuple, std::index_sequence<Indexes...>) {
+        size_t seed = 0;
+        ((seed = HashCombine(seed, std::hash<std::decay_t<Elements>>{}(tuple.template get<Indexes>()))), ...);
+        return seed;
+    }
+
+    // Если итератор возвращает не ссылку, а прокси-объект (как итератор std::vector<bool>), то константный обход
+    //  возвращает копию значения: ссылка на значение, полученное из прокси, указывала бы на временный объект.
     template<typename Iterator>
     struct value_helper {
         using value = typename std::iterator_traits<Iterator>::reference;
-        using const_value = const typename std::iterator_traits<Iterator>::value_type&;
+        using const_value = std::conditional_t<std::is_lvalue_reference_v<value>,
+                const typename std::iterator_traits<Iterator>::value_type&,
+                typename std::iterator_traits<Iterator>::value_type>;
+        // Тип, возвращаемый iter_move: rvalue-ссылка на элемент, если разыменование возвращает ссылку.
+        using rvalue = std::conditional_t<std::is_reference_v<value>, std::remove_reference_t<value>&&, value>;
     };
 
     template<typename... Iterators>
     struct value_helper<ZipIterator<Iterators...>> {
         using value = typename ZipIterator<Iterators...>::value_type;
         using const_value = typename ConstZipIterator<Iterators...>::value_type;
+        using rvalue = Tuple<typename value_helper<Iterators>::rvalue...>;
     };
 
     template<typename... Iterators>
     struct value_helper<ConstZipIterator<Iterators...>> {
         using value = typename ConstZipIterator<Iterators...>::value_type;
         using const_value = typename ConstZipIterator<Iterators...>::value_type;
+        using rvalue = typename ConstZipIterator<Iterators...>::value_type;
     };
 
+    template <typename T>
+    struct IsZipIterator : public std::false_type {};
+
+    template <typename... Iterators>
+    struct IsZipIterator<ZipIterator<Iterators...>> : public std::true_type {};
+
+    template <typename... Iterators>
+    struct IsZipIterator<ConstZipIterator<Iterators...>> : public std::true_type {};
+
+    // Итераторы стандартной библиотеки, которые хранят только указатель на элемент, например, итераторы std::vector
+    //  и std::basic_string с любым типом элементов (__normal_iterator в libstdc++ и __wrap_iter в libc++).
+    template <typename Iterator>
+    struct IsWrappedPointer : public std::false_type {};
+
+#if defined(__GLIBCXX__)
+    template <typename T, typename Container>
+    struct IsWrappedPointer<__gnu_cxx::__normal_iterator<T*, Container>> : public std::true_type {};
+#elif defined(_LIBCPP_VERSION)
+    template <typename T>
+    struct IsWrappedPointer<std::__wrap_iter<T*>> : public std::true_type {};
+#endif
+
+    // Признак итератора, указывающего на непрерывный участок памяти, что позволяет обрабатывать столбец через указатели.
+    // До C++20 распознаются указатели, итераторы-обертки указателей libstdc++ и libc++, а в других стандартных
+    //  библиотеках - только итераторы std::vector<T> (кроме T = bool и char) и std::string; итераторы остальных
+    //  непрерывных контейнеров обрабатываются как обычные итераторы с произвольным доступом.
+    template <typename Iterator>
+    constexpr bool IsContiguousIteratorImpl() {
+#if defined(__cpp_lib_concepts)
+        return std::contiguous_iterator<Iterator>;
+#else
+        using V = typename std::iterator_traits<Iterator>::value_type;
+        if constexpr (std::is_pointer_v<Iterator> || IsWrappedPointer<Iterator>::value)
+            return true;
+        else if constexpr (!std::is_object_v<V> || std::is_abstract_v<V> || std::is_same_v<V, bool>)
+            return false;
+        else if constexpr (std::is_same_v<V, char>)
+            return std::is_same_v<Iterator, std::string::iterator> || std::is_same_v<Iterator, std::string::const_iterator>;
+        else
+            return std::is_same_v<Iterator, typename std::vector<V>::iterator> || std::is_same_v<Iterator, typename std::vector<V>::const_iterator>;
+#endif
+    }
+
+    template <typename Iterator>
+    struct IsContiguousIterator : public std::bool_constant<IsContiguousIteratorImpl<Iterator>()> {};
+
+    // Длина контейнера, известная на этапе компиляции: массивы в стиле C, std::array, std::span с фиксированной длиной
+    //  и объекты Zip из таких контейнеров. Для остальных типов значение равно kDynamicExtent.
+    inline constexpr size_t kDynamicExtent = static_cast<size_t>(-1);
+
+    template <typename T>
+    struct StaticExtent : public std::integral_constant<size_t, kDynamicExtent> {};
+
+    template <typename T, size_t N>
+    struct StaticExtent<T[N]> : public std::integral_constant<size_t, N> {};
+
+    template <typename T, size_t N>
+    struct StaticExtent<std::array<T, N>> : public std::integral_constant<size_t, N> {};
+
+#if defined(__cpp_lib_span)
+    template <typename T, size_t N>
+    struct StaticExtent<std::span<T, N>> : public std::integral_constant<size_t, N> {};
+#endif
+
+    template <typename... Types>
+    struct StaticExtent<Zip<Types...>> : public std::integral_constant<size_t, Zip<Types...>::static_size> {};
+
+    // Длина zip известна, только если известны длины всех контейнеров.
+    template <size_t... Extents>
+    constexpr size_t CombineExtents() {
+        if constexpr (sizeof...(Extents) == 0) {
+            return 0;
+        } else {
+            size_t result = kDynamicExtent;
+            for (size_t extent : {Extents...}) {
+                if (extent == kDynamicExtent)
+                    return kDynamicExtent;
+                result = std::min(result, extent);
+            }
+            return result;
+        }
+    }
+
     template<typename... Iters>
     struct category_helper {
         using type = std::common_type_t<typename std::iterator_traits<Iters>::iterator_category...>;
@@ -88,22 +279,27 @@ namespace zip_impl {
     public:
         using Base = std::tuple<Iters...>;
         using Base::Base;
-        BaseZipIterator(const Base& base) : Base(base) {}
-        BaseZipIterator(Base&& base) : Base(std::move(base)) {}
+        constexpr BaseZipIterator(const Base& base) : Base(base) {}
+        constexpr BaseZipIterator(Base&& base) : Base(std::move(base)) {}
 
         using iterator_category = typename category_helper<Iters...>::type;
         static_assert(std::is_convertible_v<iterator_category, std::input_iterator_tag>);
     protected:
-        template <typename required_tag>
-        using minimal_category = std::enable_if_t<std::is_convertible_v<iterator_category, required_tag>, int>;
+        // Категория передается отдельным параметром, чтобы условие зависело от параметров шаблона метода
+        //  и не приводило к ошибке компиляции при инстанцировании класса с итераторами более слабой категории.
+        template <typename Category, typename required_tag>
+        using minimal_category = std::enable_if_t<std::is_convertible_v<Category, required_tag>, int>;
 
         template<typename F, size_t... Indexes>
-        inline void ApplyToIterators(F&& f, std::integer_sequence<size_t, Indexes...>) {
+        constexpr void ApplyToIterators(F&& f, std::integer_sequence<size_t, Indexes...>) {
+            ZIPCPP_COUNT(advances, 1);
+            ZIPCPP_COUNT(iterator_advances, sizeof...(Indexes));
             ((f(std::get<Indexes>(*this))), ...);
         }
 
         template<typename Self, bool default_value, typename F, size_t... Indexes>
-        inline bool AnyPair(F&& f, const Self& other, std::integer_sequence<size_t, Indexes...>) const {
+        constexpr bool AnyPair(F&& f, const Self& other, std::integer_sequence<size_t, Indexes...>) const {
+            ZIPCPP_COUNT(comparisons, 1);
             if constexpr (sizeof...(Indexes) != 0)
                 return (... || f(std::get<Indexes>(*this), std::get<Indexes>(other)));
             else
@@ -111,19 +307,20 @@ namespace zip_impl {
         }
 
         template<typename Value, size_t... Indexes>
-        inline Value CombineValues(std::integer_sequence<size_t, Indexes...>) {
+        constexpr Value CombineValues(std::integer_sequence<size_t, Indexes...>) {
+            ZIPCPP_COUNT(dereferences, 1);
             return Value(*std::get<Indexes>(*this)...);
         }
     public:
-        inline const Base& AsTuple() const { return *this; }
+        constexpr const Base& AsTuple() const { return *this; }
     };
 
     template<typename... Iters>
     class ZipIterator : public BaseZipIterator<Iters...> {
     public:
         using BaseZipIterator<Iters...>::BaseZipIterator;
-        ZipIterator(const typename BaseZipIterator<Iters...>::Base& base) : BaseZipIterator<Iters...>(base) {}
-        ZipIterator(typename BaseZipIterator<Iters...>::Base&& base) : BaseZipIterator<Iters...>(std::move(base)) {}
+        constexpr ZipIterator(const typename BaseZipIterator<Iters...>::Base& base) : BaseZipIterator<Iters...>(base) {}
+        constexpr ZipIterator(typename BaseZipIterator<Iters...>::Base&& base) : BaseZipIterator<Iters...>(std::move(base)) {}
 
         using Self = ZipIterator<Iters...>;
 
@@ -131,40 +328,41 @@ namespace zip_impl {
         using difference_type = int;
         using pointer = value_type*;
         using reference = value_type&;
+        using iterator_category = typename BaseZipIterator<Iters...>::iterator_category;
     private:
-        template <typename required_tag>
-        using minimal_category = typename BaseZipIterator<Iters...>::template minimal_category<required_tag>;
+        template <typename Category, typename required_tag>
+        using minimal_category = typename BaseZipIterator<Iters...>::template minimal_category<Category, required_tag>;
 
     public:
-        Self& operator++() {
+        constexpr Self& operator++() {
             this->ApplyToIterators([](auto& x){ ++x; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        Self operator++(int) {
+        constexpr Self operator++(int) {
             auto it = *this;
             ++(*this);
             return it;
         }
 
-        template <typename = minimal_category<std::bidirectional_iterator_tag>>
-        Self& operator--() {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::bidirectional_iterator_tag>>
+        constexpr Self& operator--() {
             this->ApplyToIterators([](auto& x){ --x; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        template <typename = minimal_category<std::bidirectional_iterator_tag>>
-        Self operator--(int) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::bidirectional_iterator_tag>>
+        constexpr Self operator--(int) {
             auto it = *this;
             --(*this);
             return it;
         }
 
-        value_type operator*() {
+        constexpr value_type operator*() {
             return this->template CombineValues<value_type>(std::index_sequence_for<Iters...>{});
         }
 
-        bool operator==(const Self& other) const {
+        constexpr bool operator==(const Self& other) const {
             if (this == &other)
                 return true;
             // Поскольку при сравнении итераторов, полученных из разных контейнеров,
@@ -188,66 +386,66 @@ namespace zip_impl {
             return this->template AnyPair<Self, true>([](const auto& it1, const auto& it2){ return it1==it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        inline bool operator!=(const Self& other) const {
+        constexpr bool operator!=(const Self& other) const {
             return !operator==(other);
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self& operator+=(int n) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self& operator+=(int n) {
             this->ApplyToIterators([n](auto& it) { it += n; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self operator+(int n) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self operator+(int n) const {
             auto copy = *this;
             return copy += n;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self& operator-=(int n) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self& operator-=(int n) {
             this->ApplyToIterators([n](auto& it) { it -= n; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self operator-(int n) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self operator-(int n) const {
             auto copy = *this;
             return copy -= n;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        difference_type operator-(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr difference_type operator-(const Self& other) const {
             static_assert(sizeof...(Iters) != 0);
             return std::get<0>(*this) - std::get<0>(other);
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator>(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator>(const Self& other) const {
             return this->template AnyPair<Self, false>([](const auto& it1, const auto& it2){ return it1 > it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator<(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator<(const Self& other) const {
             return this->template AnyPair<Self, false>([](const auto& it1, const auto& it2){ return it1 < it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator>=(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator>=(const Self& other) const {
             return this->template AnyPair<Self, true>([](const auto& it1, const auto& it2){ return it1 >= it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator<=(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator<=(const Self& other) const {
             return this->template AnyPair<Self, true>([](const auto& it1, const auto& it2){ return it1 <= it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        value_type operator[](size_t index) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr value_type operator[](size_t index) {
             return *(*this + index);
         }
 
-        void Swap(Self& other) {
+        constexpr void Swap(Self& other) {
             std::tuple<Iters...>::swap(other);
         }
     };
@@ -256,8 +454,8 @@ namespace zip_impl {
     class ConstZipIterator : public BaseZipIterator<Iters...> {
     public:
         using BaseZipIterator<Iters...>::BaseZipIterator;
-        ConstZipIterator(const typename BaseZipIterator<Iters...>::Base& base) : BaseZipIterator<Iters...>(base) {}
-        ConstZipIterator(typename BaseZipIterator<Iters...>::Base&& base) : BaseZipIterator<Iters...>(std::move(base)) {}
+        constexpr ConstZipIterator(const typename BaseZipIterator<Iters...>::Base& base) : BaseZipIterator<Iters...>(base) {}
+        constexpr ConstZipIterator(typename BaseZipIterator<Iters...>::Base&& base) : BaseZipIterator<Iters...>(std::move(base)) {}
 
         using Self = ConstZipIterator<Iters...>;
 
@@ -265,119 +463,516 @@ namespace zip_impl {
         using difference_type = int;
         using pointer = value_type*;
         using reference = value_type&;
+        using iterator_category = typename BaseZipIterator<Iters...>::iterator_category;
     private:
-        template <typename required_tag>
-        using minimal_category = typename BaseZipIterator<Iters...>::template minimal_category<required_tag>;
+        template <typename Category, typename required_tag>
+        using minimal_category = typename BaseZipIterator<Iters...>::template minimal_category<Category, required_tag>;
 
     public:
-        Self& operator++() {
+        constexpr Self& operator++() {
             this->ApplyToIterators([](auto& x){ ++x; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        Self operator++(int) {
+        constexpr Self operator++(int) {
             auto it = *this;
             ++(*this);
             return it;
         }
 
-        template <typename = minimal_category<std::bidirectional_iterator_tag>>
-        Self& operator--() {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::bidirectional_iterator_tag>>
+        constexpr Self& operator--() {
             this->ApplyToIterators([](auto& x){ --x; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        template <typename = minimal_category<std::bidirectional_iterator_tag>>
-        Self operator--(int) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::bidirectional_iterator_tag>>
+        constexpr Self operator--(int) {
             auto it = *this;
             --(*this);
             return it;
         }
 
-        value_type operator*() {
+        constexpr value_type operator*() {
             return this->template CombineValues<value_type>(std::index_sequence_for<Iters...>{});
         }
 
-        bool operator==(const Self& other) const {
+        constexpr bool operator==(const Self& other) const {
             if (this == &other)
                 return true;
             return this->template AnyPair<Self, true>([](const auto& it1, const auto& it2){ return it1==it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        inline bool operator!=(const Self& other) const {
+        constexpr bool operator!=(const Self& other) const {
             return !operator==(other);
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self& operator+=(int n) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self& operator+=(int n) {
             this->ApplyToIterators([n](auto& it) { it += n; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self operator+(int n) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self operator+(int n) const {
             auto copy = *this;
             return copy += n;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self& operator-=(int n) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self& operator-=(int n) {
             this->ApplyToIterators([n](auto& it) { it -= n; }, std::index_sequence_for<Iters...>{});
             return *this;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        Self operator-(int n) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr Self operator-(int n) const {
             auto copy = *this;
             return copy -= n;
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        difference_type operator-(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr difference_type operator-(const Self& other) const {
             static_assert(sizeof...(Iters) != 0);
             return std::get<0>(*this) - std::get<0>(other);
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator>(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator>(const Self& other) const {
             return this->template AnyPair<Self, false>([](const auto& it1, const auto& it2){ return it1 > it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator<(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator<(const Self& other) const {
             return this->template AnyPair<Self, false>([](const auto& it1, const auto& it2){ return it1 < it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator>=(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator>=(const Self& other) const {
             return this->template AnyPair<Self, true>([](const auto& it1, const auto& it2){ return it1 >= it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        bool operator<=(const Self& other) const {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr bool operator<=(const Self& other) const {
             return this->template AnyPair<Self, true>([](const auto& it1, const auto& it2){ return it1 <= it2; }, other, std::index_sequence_for<Iters...>{});
         }
 
-        template <typename = minimal_category<std::random_access_iterator_tag>>
-        value_type operator[](size_t index) {
+        template <typename Category = iterator_category, typename = minimal_category<Category, std::random_access_iterator_tag>>
+        constexpr value_type operator[](size_t index) {
             return *(*this + index);
         }
 
-        void Swap(Self& other) {
+        constexpr void Swap(Self& other) {
             std::tuple<Iters...>::swap(other);
         }
     };
 
     template <typename ... Iters, typename = std::enable_if_t<std::is_convertible_v<typename ZipIterator<Iters...>::iterator_category, std::random_access_iterator_tag>, int>>
-    inline auto operator+(int n, const ZipIterator<Iters...>& it) {
+    constexpr auto operator+(int n, const ZipIterator<Iters...>& it) {
         return it + n;
     }
 
     template <typename ... Iters, typename = std::enable_if_t<std::is_convertible_v<typename ConstZipIterator<Iters...>::iterator_category, std::random_access_iterator_tag>, int>>
-    inline auto operator+(int n, const ConstZipIterator<Iters...>& it) {
+    constexpr auto operator+(int n, const ConstZipIterator<Iters...>& it) {
         return it + n;
     }
 
+    template <typename... Iters>
+    constexpr typename value_helper<ZipIterator<Iters...>>::rvalue iter_move(const ZipIterator<Iters...>& it);
+
+    template <typename Iterator>
+    constexpr typename value_helper<Iterator>::rvalue MoveElement(const Iterator& it) {
+        if constexpr (IsZipIterator<Iterator>::value) {
+            return iter_move(it);
+        } else {
+            return static_cast<typename value_helper<Iterator>::rvalue>(*it);
+        }
+    }
+
+    template <typename... Iters>
+    constexpr typename value_helper<ConstZipIterator<Iters...>>::rvalue iter_move(ConstZipIterator<Iters...> it) {
+        return *it;
+    }
+
+    // Аналог std::ranges::iter_move, находимый через ADL: строка из rvalue-ссылок на элементы,
+    //  присваивание или преобразование которой перемещает значения из контейнеров.
+    template <typename... Iters>
+    constexpr typename value_helper<ZipIterator<Iters...>>::rvalue iter_move(const ZipIterator<Iters...>& it) {
+        return std::apply([](const auto&... iterators) {
+            return typename value_helper<ZipIterator<Iters...>>::rvalue(MoveElement(iterators)...);
+        }, it.AsTuple());
+    }
+
+    // Столбец объекта, возвращаемого Zip::moving: диапазон итераторов std::move_iterator.
+    template <typename Iterator>
+    class MovingColumn {
+        static_assert(!IsZipIterator<Iterator>::value, "moving() is not supported for nested Zip columns");
+    public:
+        constexpr MovingColumn(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+        constexpr std::move_iterator<Iterator> begin() const { return first_; }
+        constexpr std::move_iterator<Iterator> end() const { return last_; }
+
+    private:
+        std::move_iterator<Iterator> first_;
+        std::move_iterator<Iterator> last_;
+    };
+
+    // Диапазон с произвольным доступом, элементы которого вычисляются генератором по номеру элемента.
+    // Итераторы хранят указатель на генератор, поэтому диапазон должен существовать, пока используются его итераторы.
+    template <typename Generator>
+    class IndexedRange {
+    public:
+        using value_type = decltype(std::declval<const Generator&>()(size_t{}));
+
+        class iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = typename IndexedRange::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            iterator() = default;
+            iterator(const Generator* generator, difference_type index) : generator_(generator), index_(index) {}
+
+            inline value_type operator*() const { return (*generator_)(static_cast<size_t>(index_)); }
+            inline value_type operator[](difference_type n) const { return *(*this + n); }
+
+            inline iterator& operator++() { ++index_; return *this; }
+            inline iterator operator++(int) { auto it = *this; ++index_; return it; }
+            inline iterator& operator--() { --index_; return *this; }
+            inline iterator operator--(int) { auto it = *this; --index_; return it; }
+            inline iterator& operator+=(difference_type n) { index_ += n; return *this; }
+            inline iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+            inline iterator operator+(difference_type n) const { return iterator(generator_, index_ + n); }
+            inline iterator operator-(difference_type n) const { return iterator(generator_, index_ - n); }
+            inline difference_type operator-(const iterator& other) const { return index_ - other.index_; }
+
+            inline bool operator==(const iterator& other) const { return index_ == other.index_; }
+            inline bool operator!=(const iterator& other) const { return index_ != other.index_; }
+            inline bool operator<(const iterator& other) const { return index_ < other.index_; }
+            inline bool operator>(const iterator& other) const { return index_ > other.index_; }
+            inline bool operator<=(const iterator& other) const { return index_ <= other.index_; }
+            inline bool operator>=(const iterator& other) const { return index_ >= other.index_; }
+
+        private:
+            const Generator* generator_ = nullptr;
+            difference_type index_ = 0;
+        };
+
+        IndexedRange(Generator generator, size_t size) : generator_(std::move(generator)), size_(size) {}
+
+        inline iterator begin() const { return iterator(&generator_, 0); }
+        inline iterator end() const { return iterator(&generator_, static_cast<std::ptrdiff_t>(size_)); }
+        inline size_t size() const { return size_; }
+        inline value_type operator[](size_t index) const { return generator_(index); }
+
+    private:
+        Generator generator_;
+        size_t size_;
+    };
+
+    // Строки с номерами из [first, last); границы ограничиваются длиной диапазона, как при взятии среза в Python.
+    template <typename Source>
+    constexpr decltype(auto) SliceOf(Source& source, size_t first, size_t last) {
+        size_t size = source.size();
+        last = std::min(last, size);
+        first = std::min(first, last);
+        auto begin = source.begin();
+        return source.subrange(begin + static_cast<int>(first), begin + static_cast<int>(last));
+    }
+
+    template <typename Source, typename Iterator>
+    class ChunkGenerator {
+    public:
+        ChunkGenerator(const Source& source, Iterator first, size_t size, size_t chunk)
+                : source_(source), first_(first), size_(size), chunk_(chunk) {}
+
+        inline decltype(auto) operator()(size_t index) const {
+            size_t last = std::min(size_, (index + 1) * chunk_);
+            return source_.subrange(first_ + static_cast<int>(index * chunk_), first_ + static_cast<int>(last));
+        }
+
+    private:
+        Source source_;
+        Iterator first_;
+        size_t size_;
+        size_t chunk_;
+    };
+
+    template <typename Source>
+    auto ChunksOf(Source& source, size_t chunk) {
+        if (chunk == 0)
+            throw std::invalid_argument("chunks() requires a positive chunk size");
+        size_t size = source.size();
+        auto first = source.begin();
+        using Generator = ChunkGenerator<std::remove_const_t<Source>, decltype(first)>;
+        return IndexedRange<Generator>(Generator(source, first, size, chunk), (size + chunk - 1) / chunk);
+    }
+
+    template <typename Iterator>
+    class StrideGenerator {
+    public:
+        StrideGenerator(Iterator first, size_t stride) : first_(first), stride_(stride) {}
+
+        inline auto operator()(size_t index) const {
+            return *(first_ + static_cast<int>(index * stride_));
+        }
+
+    private:
+        Iterator first_;
+        size_t stride_;
+    };
+
+    template <typename Source>
+    auto StrideOf(Source& source, size_t stride) {
+        if (stride == 0)
+            throw std::invalid_argument("stride() requires a positive step");
+        size_t size = source.size();
+        auto first = source.begin();
+        using Generator = StrideGenerator<decltype(first)>;
+        return IndexedRange<Generator>(Generator(first, stride), (size + stride - 1) / stride);
+    }
+
+    // На сколько выбранных строк вперед элементы столбцов в непрерывной памяти загружаются в кэш при обходе take.
+    inline constexpr size_t kGatherPrefetchDistance = 16;
+
+    template <typename Iterator>
+    inline void PrefetchElement(const Iterator& first, size_t row) {
+        if constexpr (IsContiguousIterator<Iterator>::value)
+            Prefetch(std::addressof(first[static_cast<typename std::iterator_traits<Iterator>::difference_type>(row)]));
+    }
+
+    template <typename Iterator, typename Index>
+    class GatherGenerator {
+    public:
+        GatherGenerator(Iterator first, const Index* indices, size_t size) : first_(first), indices_(indices), size_(size) {}
+
+        inline auto operator()(size_t position) const {
+            if (position + kGatherPrefetchDistance < size_)
+                PrefetchRow(static_cast<size_t>(indices_[position + kGatherPrefetchDistance]),
+                            std::make_index_sequence<std::tuple_size_v<typename Iterator::Base>>{});
+            return *(first_ + static_cast<int>(indices_[position]));
+        }
+
+    private:
+        template <size_t... Indexes>
+        inline void PrefetchRow(size_t row, std::index_sequence<Indexes...>) const {
+            (PrefetchElement(std::get<Indexes>(first_.AsTuple()), row), ...);
+        }
+
+        Iterator first_;
+        const Index* indices_;
+        size_t size_;
+    };
+
+    inline unsigned CountTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+        unsigned count = 0;
+        for (; (word & 1) == 0; word >>= 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    /* Строки объекта Zip, отмеченные единичными битами маски (бит i слова w соответствует строке 64 * w + i).
+     * Итератор переходит к следующей выбранной строке сбросом младшего единичного бита и подсчетом нулевых битов
+     *  (ctz), а строка получается смещением итератора произвольного доступа, поэтому обход не содержит
+     *  трудно предсказуемых ветвлений по отдельным строкам.
+     */
+    template <typename Source>
+    class MaskedRange {
+        using zip_iterator = decltype(std::begin(std::declval<Source&>()));
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename zip_iterator::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            iterator(const MaskedRange* range, size_t word, uint64_t bits) : range_(range), word_(word), bits_(bits) {
+                SkipEmptyWords();
+            }
+
+            inline value_type operator*() const {
+                return *(range_->first_ + static_cast<int>(64 * word_ + CountTrailingZeros(bits_)));
+            }
+
+            inline iterator& operator++() {
+                bits_ &= bits_ - 1;
+                SkipEmptyWords();
+                return *this;
+            }
+
+            inline iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+
+            inline bool operator==(const iterator& other) const { return word_ == other.word_ && bits_ == other.bits_; }
+            inline bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            inline void SkipEmptyWords() {
+                while (bits_ == 0 && word_ < range_->words_ && ++word_ < range_->words_)
+                    bits_ = range_->Word(word_);
+            }
+
+            const MaskedRange* range_;
+            size_t word_;
+            uint64_t bits_;
+        };
+
+        MaskedRange(const Source& source, const uint64_t* mask, size_t mask_words)
+                : source_(source), first_(std::begin(source_)), mask_(mask) {
+            rows_ = source_.size();
+            words_ = std::min((rows_ + 63) / 64, mask_words);
+        }
+
+        iterator begin() const { return words_ == 0 ? end() : iterator(this, 0, Word(0)); }
+        iterator end() const { return iterator(this, words_, 0); }
+
+    private:
+        // Биты за концом диапазона не учитываются.
+        inline uint64_t Word(size_t word) const {
+            size_t tail = rows_ - 64 * word;
+            return tail >= 64 ? mask_[word] : mask_[word] & ((uint64_t{1} << tail) - 1);
+        }
+
+        Source source_;
+        zip_iterator first_;
+        const uint64_t* mask_;
+        size_t rows_;
+        size_t words_;
+    };
+
+    template <typename Source, typename Mask>
+    auto FilterOf(Source& source, const Mask& mask) {
+        static_assert(std::is_same_v<std::remove_const_t<std::remove_pointer_t<decltype(std::data(mask))>>, uint64_t>,
+                      "filter_mask() requires a contiguous container of uint64_t words");
+        return MaskedRange<std::remove_const_t<Source>>(source, std::data(mask), std::size(mask));
+    }
+
+    template <typename Source, typename Indices>
+    auto TakeOf(Source& source, const Indices& indices) {
+        auto first = source.begin();
+        using Index = std::remove_const_t<std::remove_pointer_t<decltype(std::data(indices))>>;
+        static_assert(std::is_integral_v<Index>, "take() requires a contiguous container of row numbers");
+        using Generator = GatherGenerator<decltype(first), Index>;
+        size_t size = std::size(indices);
+        return IndexedRange<Generator>(Generator(first, std::data(indices), size), size);
+    }
+
+    // Композиция функций представления map: g(f(row)) вычисляется одним вызовом без промежуточных представлений.
+    template <typename F, typename G>
+    struct ComposedMap {
+        F f;
+        G g;
+
+        template <typename Row>
+        inline decltype(auto) operator()(Row&& row) const {
+            return g(f(std::forward<Row>(row)));
+        }
+    };
+
+    /* Итератор, возвращающий при разыменовании f(*it). Категория совпадает с категорией исходного итератора.
+     * Хранит указатель на функцию в объекте MapView, поэтому он должен существовать, пока используются его итераторы.
+     */
+    template <typename Iterator, typename F>
+    class MapIterator {
+    public:
+        using iterator_category = typename std::iterator_traits<Iterator>::iterator_category;
+        using reference = std::invoke_result_t<const F&, decltype(*std::declval<Iterator&>())>;
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+        using pointer = void;
+
+        MapIterator() = default;
+        MapIterator(Iterator it, const F* f) : it_(it), f_(f) {}
+
+        inline reference operator*() const { return (*f_)(*it_); }
+        inline reference operator[](difference_type n) const { return *(*this + n); }
+
+        inline MapIterator& operator++() { ++it_; return *this; }
+        inline MapIterator operator++(int) { auto it = *this; ++it_; return it; }
+        inline MapIterator& operator--() { --it_; return *this; }
+        inline MapIterator operator--(int) { auto it = *this; --it_; return it; }
+        inline MapIterator& operator+=(difference_type n) { it_ += n; return *this; }
+        inline MapIterator& operator-=(difference_type n) { it_ -= n; return *this; }
+        inline MapIterator operator+(difference_type n) const { return MapIterator(it_ + n, f_); }
+        inline MapIterator operator-(difference_type n) const { return MapIterator(it_ - n, f_); }
+        inline difference_type operator-(const MapIterator& other) const { return it_ - other.it_; }
+
+        inline bool operator==(const MapIterator& other) const { return it_ == other.it_; }
+        inline bool operator!=(const MapIterator& other) const { return it_ != other.it_; }
+        inline bool operator<(const MapIterator& other) const { return it_ < other.it_; }
+        inline bool operator>(const MapIterator& other) const { return it_ > other.it_; }
+        inline bool operator<=(const MapIterator& other) const { return it_ <= other.it_; }
+        inline bool operator>=(const MapIterator& other) const { return it_ >= other.it_; }
+
+        inline const Iterator& base() const { return it_; }
+
+    private:
+        // Итераторы Zip разыменовываются только неконстантным operator*.
+        mutable Iterator it_;
+        const F* f_ = nullptr;
+    };
+
+    /* Ленивое представление: строки диапазона [first, last) заменяются на f(row) при разыменовании, без промежуточных
+     *  контейнеров. Повторный map объединяет функции в одну, поэтому цепочка map(f).map(g) обходит исходные итераторы
+     *  и вызывает g(f(row)) без вложенных представлений. Представления с произвольным доступом поддерживают
+     *  slice и chunks и могут передаваться в функции, принимающие объекты Zip с произвольным доступом.
+     */
+    template <typename Iterator, typename F>
+    class MapView {
+        template <typename Category>
+        using random_access_only = std::enable_if_t<std::is_convertible_v<Category, std::random_access_iterator_tag>, int>;
+    public:
+        using iterator = MapIterator<Iterator, F>;
+        using const_iterator = iterator;
+
+        MapView(Iterator first, Iterator last, F f) : first_(first), last_(last), f_(std::move(f)) {}
+
+        inline iterator begin() const { return iterator(first_, &f_); }
+        inline iterator end() const { return iterator(last_, &f_); }
+
+        template <typename Category = typename iterator::iterator_category,
+                  typename = std::enable_if_t<std::is_convertible_v<Category, std::forward_iterator_tag>, int>>
+        inline size_t size() const { return static_cast<size_t>(std::distance(first_, last_)); }
+
+        inline MapView subrange(const iterator& first, const iterator& last) const {
+            return MapView(first.base(), last.base(), f_);
+        }
+
+        template <typename G>
+        inline auto map(G g) const {
+            return MapView<Iterator, ComposedMap<F, G>>(first_, last_, ComposedMap<F, G>{f_, std::move(g)});
+        }
+
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto slice(size_t first, size_t last) const { return SliceOf(*this, first, last); }
+
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto chunks(size_t n) const { return ChunksOf(*this, n); }
+
+    private:
+        Iterator first_;
+        Iterator last_;
+        F f_;
+    };
+
+    template <typename T>
+    struct IsMapView : public std::false_type {};
+
+    template <typename Iterator, typename F>
+    struct IsMapView<MapView<Iterator, F>> : public std::true_type {};
+
     template<typename... Types>
     class Zip {
     public:
@@ -385,85 +980,503 @@ namespace zip_impl {
         using const_iterator = ConstZipIterator<std::remove_reference_t<decltype(std::begin(std::declval<Types>()))>...>;
     private:
         using stored_iterators_tuple = typename iterator::Base;
+
+        template <typename Category>
+        using random_access_only = std::enable_if_t<std::is_convertible_v<Category, std::random_access_iterator_tag>, int>;
     public:
-        explicit Zip(Types&& ... args);
+        // Длина диапазона, если она известна на этапе компиляции, иначе zipcpp::dynamic_extent.
+        static constexpr size_t static_size = CombineExtents<StaticExtent<std::remove_cv_t<std::remove_reference_t<Types>>>::value...>();
+
+        constexpr explicit Zip(Types&& ... args);
+
+        constexpr auto begin() { return iterator(begin_); }
+        constexpr auto end() { return iterator(end_); }
+        constexpr auto begin() const { return const_iterator(begin_); }
+        constexpr auto end() const { return const_iterator(end_); }
+
+        constexpr auto cbegin() const { return begin(); }
+        constexpr auto cend() const { return end(); }
+
+        // Поддиапазон [first, last), где first и last получены от этого же объекта.
+        // Для константных итераторов возвращается константный объект, чтобы не терять константность элементов.
+        constexpr Zip subrange(const iterator& first, const iterator& last) const {
+            return Zip(first.AsTuple(), last.AsTuple());
+        }
+        constexpr const Zip subrange(const const_iterator& first, const const_iterator& last) const {
+            return Zip(first.AsTuple(), last.AsTuple());
+        }
 
-        inline auto begin() { return iterator(begin_); }
-        inline auto end() { return iterator(end_); }
-        inline auto begin() const { return const_iterator(begin_); }
-        inline auto end() const { return const_iterator(end_); }
+        // Длина диапазона равна длине самого короткого из переданных контейнеров.
+        template <typename Category = typename iterator::iterator_category,
+                  typename = std::enable_if_t<std::is_convertible_v<Category, std::forward_iterator_tag>, int>>
+        constexpr size_t size() const {
+            return SizeImpl(std::index_sequence_for<Types...>{});
+        }
 
-        inline auto cbegin() const { return begin(); }
-        inline auto cend() const { return end(); }
+        /* Представления для объектов Zip с произвольным доступом, создаваемые за O(1) без копирования элементов.
+         * slice(first, last) - объект Zip со строками с номерами из [first, last);
+         * chunks(n) - диапазон последовательных объектов Zip по n строк (последний может быть короче),
+         *  которые можно независимо обрабатывать в разных потоках;
+         * stride(k) - диапазон строк с номерами 0, k, 2k, ...
+         * Для n = 0 и k = 0 выбрасывается std::invalid_argument.
+         */
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        constexpr decltype(auto) slice(size_t first, size_t last) { return SliceOf(*this, first, last); }
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        constexpr decltype(auto) slice(size_t first, size_t last) const { return SliceOf(*this, first, last); }
+
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto chunks(size_t n) { return ChunksOf(*this, n); }
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto chunks(size_t n) const { return ChunksOf(*this, n); }
+
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto stride(size_t k) { return StrideOf(*this, k); }
+        template <typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto stride(size_t k) const { return StrideOf(*this, k); }
+
+        /* Диапазон с произвольным доступом из строк с номерами indices[0], indices[1], ..., где indices - контейнер
+         *  целых чисел в непрерывной памяти (std::vector<uint32_t>, массив), который должен существовать во время обхода.
+         * Элементы строк - ссылки на элементы контейнеров; элементы столбцов в непрерывной памяти загружаются в кэш заранее.
+         * Представление хранит указатели на номера строк, поэтому временный контейнер номеров передать нельзя.
+         */
+        template <typename Indices, typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto take(const Indices& indices) { return TakeOf(*this, indices); }
+        template <typename Indices, typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto take(const Indices& indices) const { return TakeOf(*this, indices); }
+        template <typename Indices, typename = std::enable_if_t<!std::is_reference_v<Indices>>>
+        void take(Indices&& indices) = delete;
+        template <typename Indices, typename = std::enable_if_t<!std::is_reference_v<Indices>>>
+        void take(Indices&& indices) const = delete;
+
+        // Диапазон строк, отмеченных единичными битами маски из 64-битных слов (например, результата zipcpp::make_mask).
+        // Маска должна существовать во время обхода, поэтому временную маску передать нельзя.
+        template <typename Mask, typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto filter_mask(const Mask& mask) { return FilterOf(*this, mask); }
+        template <typename Mask, typename Category = typename iterator::iterator_category, typename = random_access_only<Category>>
+        inline auto filter_mask(const Mask& mask) const { return FilterOf(*this, mask); }
+        template <typename Mask, typename = std::enable_if_t<!std::is_reference_v<Mask>>>
+        void filter_mask(Mask&& mask) = delete;
+        template <typename Mask, typename = std::enable_if_t<!std::is_reference_v<Mask>>>
+        void filter_mask(Mask&& mask) const = delete;
+
+        /* Ленивое представление, строки которого - значения f(row) для строк row этого объекта (см. MapView).
+         * Например, для auto values = z.map(f) вызов std::accumulate(values.begin(), values.end(), 0.0) не создает
+         *  промежуточный вектор.
+         */
+        template <typename F>
+        inline auto map(F f) { return MapView<iterator, F>(begin(), end(), std::move(f)); }
+        template <typename F>
+        inline auto map(F f) const { return MapView<const_iterator, F>(begin(), end(), std::move(f)); }
+
+        /* Объект Zip по тем же строкам, итераторы которого при разыменовании возвращают кортежи rvalue-ссылок.
+         * Присваивание таких строк строкам другого объекта Zip или их преобразование в std::tuple перемещает значения,
+         *  например, std::copy(m.begin(), m.end(), std::back_inserter(rows)) для m = z.moving().
+         */
+        constexpr auto moving() { return MovingImpl(std::index_sequence_for<Types...>{}); }
     private:
+        template <size_t... Indexes>
+        constexpr auto MovingImpl(std::index_sequence<Indexes...>) const {
+            return Zip<MovingColumn<std::tuple_element_t<Indexes, stored_iterators_tuple>>...>(
+                    MovingColumn<std::tuple_element_t<Indexes, stored_iterators_tuple>>(std::get<Indexes>(begin_), std::get<Indexes>(end_))...);
+        }
+
+        template <size_t... Indexes>
+        constexpr size_t SizeImpl(std::index_sequence<Indexes...>) const {
+            return std::min({static_cast<size_t>(std::distance(std::get<Indexes>(begin_), std::get<Indexes>(end_)))...});
+        }
+
+        constexpr Zip(const stored_iterators_tuple& begin, const stored_iterators_tuple& end) : begin_(begin), end_(end) {}
+
         stored_iterators_tuple begin_;
         stored_iterators_tuple end_;
     };
 
     template<typename... Types>
-    Zip<Types...>::Zip(Types&& ... args)
+    constexpr Zip<Types...>::Zip(Types&& ... args)
             : begin_(std::begin(args)...), end_(std::end(args)...) {
     }
 
+    // Итераторы std::vector<bool>, биты которых можно читать машинными словами. Используется представление
+    //  итераторов libstdc++ (указатель на слово и номер бита в нем), для других реализаций обход выполняется по одной строке.
+    template <typename Iterator>
+    struct IsBitIterator : public std::false_type {};
+
+#if defined(__GLIBCXX__)
+    template <>
+    struct IsBitIterator<std::_Bit_iterator> : public std::true_type {};
+
+    template <>
+    struct IsBitIterator<std::_Bit_const_iterator> : public std::true_type {};
+#endif
+
+    // Столбец при обходе блоками: элементы в непрерывной памяти читаются через указатель.
+    template <typename Iterator, bool Bits = IsBitIterator<Iterator>::value>
+    class BlockColumn {
+    public:
+        using reference = typename std::iterator_traits<Iterator>::reference;
+
+        explicit BlockColumn(const Iterator& it) : data_(std::addressof(*it)) {}
+
+        inline void Load() {}
+        inline reference At(size_t index) const { return data_[index]; }
+        inline void Advance(size_t count) { data_ += count; }
+
+    private:
+        std::remove_reference_t<reference>* data_;
+    };
+
+#if defined(__GLIBCXX__)
+    // Столбец std::vector<bool>: перед обработкой блока его биты загружаются одним словом,
+    //  которое при смещении начала столбца внутри слова собирается из двух соседних слов.
+    template <typename Iterator>
+    class BlockColumn<Iterator, true> {
+    public:
+        using reference = bool;
+        static constexpr size_t kBits = std::_S_word_bit;
+
+        explicit BlockColumn(const Iterator& it) : word_(it._M_p), offset_(it._M_offset) {}
+
+        inline void Load() {
+            bits_ = offset_ == 0 ? word_[0] : (word_[0] >> offset_) | (word_[1] << (kBits - offset_));
+        }
+        inline bool At(size_t index) const { return (bits_ >> index) & 1; }
+        inline void Advance(size_t) { ++word_; }
+
+    private:
+        const std::_Bit_type* word_;
+        unsigned offset_;
+        std::_Bit_type bits_ = 0;
+    };
+
+    inline constexpr size_t kBitBlock = std::_S_word_bit;
+#else
+    inline constexpr size_t kBitBlock = 64;
+#endif
+
+    // Итератор изменяемого std::vector<bool>: его строки при обходе блоками содержали бы копии битов вместо прокси-объектов.
+    template <typename Iterator>
+    struct IsMutableBitIterator : public std::false_type {};
+
+#if defined(__GLIBCXX__)
+    template <>
+    struct IsMutableBitIterator<std::_Bit_iterator> : public std::true_type {};
+#endif
+
+    // Блоками обходятся только строки, биты которых нельзя изменить: константный объект Zip или столбцы константных
+    //  std::vector<bool>. Иначе присваивание биту в f изменяло бы копию, поэтому строки обходятся по одной с прокси-объектами.
+    template <bool Writable, typename... Iters>
+    struct BitBlockColumns : public std::bool_constant<
+            std::is_convertible_v<typename ZipIterator<Iters...>::iterator_category, std::random_access_iterator_tag>
+            && (... || IsBitIterator<Iters>::value)
+            && (... && (IsBitIterator<Iters>::value || IsContiguousIterator<Iters>::value))
+            && !(Writable && (... || IsMutableBitIterator<Iters>::value))> {};
+
+    template <typename Iterator>
+    struct UsesBitBlocks : public std::false_type {};
+
+    template <typename... Iters>
+    struct UsesBitBlocks<ZipIterator<Iters...>> : public BitBlockColumns<true, Iters...> {
+        static constexpr bool read_only = false;
+    };
+
+    template <typename... Iters>
+    struct UsesBitBlocks<ConstZipIterator<Iters...>> : public BitBlockColumns<false, Iters...> {
+        static constexpr bool read_only = true;
+    };
+
+    // Элемент строки при обходе блоками; для константного объекта Zip ссылки на элементы столбцов константны.
+    template <bool Const, typename Iterator>
+    using BlockReference = std::conditional_t<Const && std::is_lvalue_reference_v<typename BlockColumn<Iterator>::reference>,
+                                              const std::remove_reference_t<typename BlockColumn<Iterator>::reference>&,
+                                              typename BlockColumn<Iterator>::reference>;
+
+    template <bool Const, typename Base, typename F, size_t... Indexes>
+    void ForEachBitBlock(const Base& first, size_t size, F& f, std::index_sequence<Indexes...>) {
+        using Row = Tuple<BlockReference<Const, std::tuple_element_t<Indexes, Base>>...>;
+        size_t full = size / kBitBlock * kBitBlock;
+        if (full != 0) {
+            std::tuple<BlockColumn<std::tuple_element_t<Indexes, Base>>...> columns(
+                    BlockColumn<std::tuple_element_t<Indexes, Base>>(std::get<Indexes>(first))...);
+            for (size_t start = 0; start < full; start += kBitBlock) {
+                (std::get<Indexes>(columns).Load(), ...);
+                for (size_t i = 0; i < kBitBlock; ++i)
+                    f(Row(std::get<Indexes>(columns).At(i)...));
+                (std::get<Indexes>(columns).Advance(kBitBlock), ...);
+            }
+        }
+        Base it = first;
+        (std::advance(std::get<Indexes>(it), static_cast<std::ptrdiff_t>(full)), ...);
+        for (size_t i = full; i < size; ++i) {
+            f(Row(static_cast<typename BlockColumn<std::tuple_element_t<Indexes, Base>>::reference>(*std::get<Indexes>(it))...));
+            (++std::get<Indexes>(it), ...);
+        }
+    }
+
+    /* Контрольные точки для разбиения объекта Zip с однонаправленными, двунаправленными или любыми другими итераторами
+     *  на parts частей примерно равной длины, например, для параллельной обработки zip по std::list или std::map.
+     * Диапазон обходится один раз при построении, после чего части получаются за O(1) и могут обрабатываться
+     *  в разных потоках при каждом последующем проходе. После изменения контейнеров контрольные точки могут стать
+     *  недействительными: invalidate() помечает индекс устаревшим, а rebuild() заново обходит диапазон.
+     */
+    template <typename Source>
+    class SplitIndex {
+        using zip_iterator = decltype(std::begin(std::declval<Source&>()));
+
+        template <typename Index>
+        struct PartGenerator {
+            const Index* index;
+            inline auto operator()(size_t part) const { return (*index)[part]; }
+        };
+    public:
+        using part_type = decltype(std::declval<const Source&>().subrange(std::declval<zip_iterator>(), std::declval<zip_iterator>()));
+
+        SplitIndex(const Source& source, size_t parts) : source_(source), parts_(std::max<size_t>(parts, 1)) {
+            rebuild();
+        }
+
+        // Обходит диапазон и заново расставляет контрольные точки.
+        void rebuild() {
+            // Кандидаты в контрольные точки запоминаются через каждые step строк; если их становится слишком много,
+            //  каждый второй отбрасывается, а шаг удваивается, поэтому длина диапазона заранее не нужна.
+            const size_t max_samples = 2 * kSamplesPerPart * parts_;
+            std::vector<zip_iterator> samples;
+            samples.reserve(max_samples);
+            size_t step = 1;
+            size_t rows = 0;
+            auto it = std::begin(source_);
+            auto last = std::end(source_);
+            for (; it != last; ++it, ++rows) {
+                if (rows % step != 0)
+                    continue;
+                if (samples.size() == max_samples) {
+                    for (size_t i = 0; i < max_samples / 2; ++i)
+                        samples[i] = samples[2 * i];
+                    samples.erase(samples.begin() + static_cast<std::ptrdiff_t>(max_samples / 2), samples.end());
+                    step *= 2;
+                    if (rows % step != 0)
+                        continue;
+                }
+                samples.push_back(it);
+            }
+
+            checkpoints_.assign(1, std::begin(source_));
+            offsets_.assign(1, 0);
+            for (size_t part = 1; part < parts_; ++part) {
+                size_t sample = std::min((rows * part / parts_ + step / 2) / step, samples.size());
+                checkpoints_.push_back(sample < samples.size() ? samples[sample] : it);
+                offsets_.push_back(std::min(sample * step, rows));
+            }
+            checkpoints_.push_back(it);
+            offsets_.push_back(rows);
+            valid_ = true;
+        }
+
+        // Перестраивает индекс для нового объекта Zip, например, после вставки в начало контейнера.
+        void rebuild(const Source& source) {
+            source_ = source;
+            rebuild();
+        }
+
+        inline void invalidate() { valid_ = false; }
+        inline bool valid() const { return valid_; }
+
+        inline size_t size() const { return parts_; }
+        inline size_t rows() const { return offsets_.back(); }
+        inline size_t part_size(size_t part) const { return offsets_[part + 1] - offsets_[part]; }
+
+        // Часть с номером part - объект Zip по строкам между соседними контрольными точками. Индекс должен быть действительным.
+        inline part_type operator[](size_t part) const {
+            return source_.subrange(checkpoints_[part], checkpoints_[part + 1]);
+        }
+
+        // Диапазон с произвольным доступом из всех частей.
+        inline auto parts() const {
+            using Generator = PartGenerator<SplitIndex>;
+            return IndexedRange<Generator>(Generator{this}, parts_);
+        }
+
+    private:
+        static constexpr size_t kSamplesPerPart = 16;
+
+        Source source_;
+        size_t parts_;
+        std::vector<zip_iterator> checkpoints_;
+        std::vector<size_t> offsets_;
+        bool valid_ = false;
+    };
+
+    // Наибольшая длина диапазона, для которой for_each_static полностью разворачивает цикл.
+    inline constexpr size_t kUnrollLimit = 32;
+
+    template <typename Iterator, typename F, size_t... Indexes>
+    constexpr void UnrolledForEach(Iterator& it, F& f, std::index_sequence<Indexes...>) {
+        ((static_cast<void>(Indexes), f(*it), ++it), ...);
+    }
+
     template <typename ... Types>
-    void swap(ZipIterator<Types...>& it1, ZipIterator<Types...>& it2) {
+    constexpr void swap(ZipIterator<Types...>& it1, ZipIterator<Types...>& it2) {
         it1.Swap(it2);
     }
 
     template <typename ... Elements>
-    void swap(const Tuple<Elements...>& lhs, const Tuple<Elements...>& rhs) {
+    constexpr void swap(const Tuple<Elements...>& lhs, const Tuple<Elements...>& rhs) {
         using std::swap;
         swap(lhs.base, rhs.base);
     }
 
     template <typename ... Elements>
-    void swap(Tuple<Elements...>&& lhs, Tuple<Elements...>&& rhs) {
+    constexpr void swap(Tuple<Elements...>&& lhs, Tuple<Elements...>&& rhs) {
         using std::swap;
         swap(lhs.base, rhs.base);
     }
 
     template <size_t Index, typename ... Elements>
-    auto& get(const Tuple<Elements...>& tup) {
+    constexpr decltype(auto) get(const Tuple<Elements...>& tup) {
         return tup.template get<Index>();
     }
 
     template <typename ... Args1, typename ... Args2>
-    bool operator==(const Tuple<Args1...>& lhs, const Tuple<Args2...>& rhs) {
+    constexpr bool operator==(const Tuple<Args1...>& lhs, const Tuple<Args2...>& rhs) {
         return lhs.base == rhs.base;
     }
 
     template <typename ... Args1, typename ... Args2>
-    bool operator==(const std::tuple<Args1...>& lhs, const Tuple<Args2...>& rhs) {
+    constexpr bool operator==(const std::tuple<Args1...>& lhs, const Tuple<Args2...>& rhs) {
         return lhs == rhs.base;
     }
 
     template <typename ... Args1, typename ... Args2>
-    bool operator==(const Tuple<Args1...>& lhs, const std::tuple<Args2...>& rhs) {
+    constexpr bool operator==(const Tuple<Args1...>& lhs, const std::tuple<Args2...>& rhs) {
         return lhs.base == rhs;
     }
 
     template <typename ... Args1, typename ... Args2>
-    bool operator<(const Tuple<Args1...>& lhs, const Tuple<Args2...>& rhs) {
+    constexpr bool operator<(const Tuple<Args1...>& lhs, const Tuple<Args2...>& rhs) {
         return lhs.base < rhs.base;
     }
 }
 
 
-namespace zipcpp {
+ZIPCPP_EXPORT namespace zipcpp {
     template<typename... Types>
-    zip_impl::Zip<Types...> zip(Types&& ... args) {
+    constexpr zip_impl::Zip<Types...> zip(Types&& ... args) {
         return zip_impl::Zip<Types...>(std::forward<Types>(args)...);
     }
 
+    // То же, что zip(args...).moving(): при обходе значения перемещаются из контейнеров, а не копируются.
+    template<typename... Types>
+    constexpr auto move_zip(Types&& ... args) {
+        return zip(std::forward<Types>(args)...).moving();
+    }
+
+    /* Ленивое представление диапазона, элементы которого - значения f(x) для элементов x диапазона (для объектов Zip - строк).
+     * Для представления, полученного map или transform_view, функции объединяются в одну, как в map(f).map(g).
+     * Диапазон должен существовать во время обхода.
+     */
+    template <typename Range, typename F>
+    auto transform_view(Range&& range, F f) {
+        if constexpr (zip_impl::IsMapView<std::remove_cv_t<std::remove_reference_t<Range>>>::value)
+            return range.map(std::move(f));
+        else
+            return zip_impl::MapView<decltype(std::begin(range)), F>(std::begin(range), std::end(range), std::move(f));
+    }
+
+#if defined(__cpp_lib_span)
+    using std::dynamic_extent;
+#else
+    inline constexpr size_t dynamic_extent = zip_impl::kDynamicExtent;
+#endif
+
     template <typename Iter>
     class IterRange {
         Iter begin_;
         Iter end_;
     public:
-        IterRange(Iter begin, Iter end) : begin_(begin), end_(end) {}
-        Iter begin() const { return begin_; }
-        Iter end() const { return end_; }
+        constexpr IterRange(Iter begin, Iter end) : begin_(begin), end_(end) {}
+        constexpr Iter begin() const { return begin_; }
+        constexpr Iter end() const { return end_; }
     };
+
+    /* Битовая маска строк объекта Zip с произвольным доступом, для которых pred(row) истинно:
+     *  бит i слова w соответствует строке 64 * w + i. Результат предиката записывается в маску без ветвлений,
+     *  поэтому для простых предикатов цикл векторизуется.
+     */
+    template <typename ZipType, typename Predicate>
+    std::vector<uint64_t> make_mask(ZipType&& rows, Predicate&& pred) {
+        size_t size = rows.size();
+        std::vector<uint64_t> mask((size + 63) / 64);
+        auto it = std::begin(rows);
+        for (size_t word = 0; word < mask.size(); ++word) {
+            size_t count = std::min<size_t>(64, size - 64 * word);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < count; ++i, ++it)
+                bits |= static_cast<uint64_t>(static_cast<bool>(pred(*it))) << i;
+            mask[word] = bits;
+        }
+        return mask;
+    }
+
+    /* Перемещает строки объекта Zip с произвольным доступом, для которых pred(row) истинно, в начало диапазона
+     *  с сохранением их порядка и возвращает итератор на конец оставленных строк (как std::remove_if для обратного условия).
+     * Сначала предикат вычисляется для всех строк в битовую маску, затем выбранные строки перебираются по единичным битам.
+     */
+    template <typename ZipType, typename Predicate>
+    auto compact(ZipType&& rows, Predicate&& pred) {
+        std::vector<uint64_t> mask = make_mask(rows, pred);
+        auto first = std::begin(rows);
+        int kept = 0;
+        for (size_t word = 0; word < mask.size(); ++word) {
+            for (uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+                int row = static_cast<int>(64 * word + zip_impl::CountTrailingZeros(bits));
+                if (row != kept)
+                    *(first + kept) = iter_move(first + row);
+                ++kept;
+            }
+        }
+        return first + kept;
+    }
+
+    // Индекс контрольных точек для разбиения объекта Zip на parts частей без повторного обхода при каждом разбиении.
+    template <typename ZipType>
+    auto split_index(ZipType&& rows, size_t parts) {
+        return zip_impl::SplitIndex<std::remove_cv_t<std::remove_reference_t<ZipType>>>(rows, parts);
+    }
+
+    /* Вызывает f для каждой строки объекта Zip.
+     * Если среди столбцов с произвольным доступом есть std::vector<bool>, а остальные столбцы расположены в непрерывной памяти,
+     *  и биты нельзя изменить через строки (объект Zip константный или std::vector<bool> константные), то биты читаются
+     *  машинными словами по 64 строки, а в f передаются кортежи, в которых биты представлены значениями bool.
+     *  Иначе в f передаются строки, возвращаемые итераторами, и присваивание биту изменяет контейнер.
+     */
+    template <typename ZipType, typename F>
+    void for_each_row(ZipType&& rows, F&& f) {
+        auto first = std::begin(rows);
+        if constexpr (zip_impl::UsesBitBlocks<decltype(first)>::value) {
+            using Base = typename decltype(first)::Base;
+            zip_impl::ForEachBitBlock<zip_impl::UsesBitBlocks<decltype(first)>::read_only>(first.AsTuple(), rows.size(), f, std::make_index_sequence<std::tuple_size_v<Base>>{});
+        } else {
+            for (auto&& row : rows)
+                f(std::forward<decltype(row)>(row));
+        }
+    }
+
+    /* Вызывает f для каждой строки объекта Zip, длина которого известна на этапе компиляции (Zip::static_size).
+     * Для коротких диапазонов цикл полностью разворачивается, для длинных выполняется цикл с постоянным
+     *  числом итераций. В обоих случаях проверки достижения конца диапазона не выполняются.
+     */
+    template <typename ZipType, typename F>
+    constexpr void for_each_static(ZipType&& rows, F&& f) {
+        constexpr size_t size = std::remove_reference_t<ZipType>::static_size;
+        static_assert(size != dynamic_extent, "for_each_static requires containers with compile-time length");
+        auto it = std::begin(rows);
+        if constexpr (size <= zip_impl::kUnrollLimit) {
+            zip_impl::UnrolledForEach(it, f, std::make_index_sequence<size>{});
+        } else {
+            for (size_t i = 0; i < size; ++i, ++it)
+                f(*it);
+        }
+    }
 }
 
 namespace std {
@@ -472,4 +1485,12 @@ namespace std {
 
     template <size_t Index, typename ... Types>
     struct tuple_element<Index, zip_impl::Tuple<Types...>> : public tuple_element<Index, std::tuple<Types...>> {};
+
+    // Хеш кортежа вычисляется по значениям элементов, поэтому кортежи ссылок на равные значения имеют равные хеши.
+    template <typename ... Types>
+    struct hash<zip_impl::Tuple<Types...>> {
+        size_t operator()(const zip_impl::Tuple<Types...>& tuple) const {
+            return zip_impl::HashTuple(tuple, std::index_sequence_for<Types...>{});
+        }
+    };
 }
@@ -0,0 +1,250 @@
+#pragma once
+#include <array>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "zip.h"
+
+namespace zip_impl {
+    template <size_t, typename T>
+    using Repeat = T;
+
+    template <typename Element, typename Sequence>
+    struct RepeatedTuple;
+
+    template <typename Element, size_t... Indexes>
+    struct RepeatedTuple<Element, std::index_sequence<Indexes...>> {
+        using type = Tuple<Repeat<Indexes, Element>...>;
+    };
+
+    // Кортеж из N элементов типа Element.
+    template <typename Element, size_t N>
+    using RepeatedTupleT = typename RepeatedTuple<Element, std::make_index_sequence<N>>::type;
+
+    // Тип значений, копируемых в окно однопроходного диапазона: строки zip копируются в std::tuple значений,
+    //  так как ссылки строки перестают быть действительными после перехода к следующей строке.
+    template <typename T>
+    struct WindowValue {
+        using type = T;
+    };
+
+    template <typename... Elements>
+    struct WindowValue<Tuple<Elements...>> {
+        using type = std::tuple<std::decay_t<Elements>...>;
+    };
+
+    /* Окно из N последовательных элементов диапазона с произвольным доступом, начинающееся с элемента с номером index.
+     * Хранится только итератор на начало диапазона (для непрерывной памяти - указатель), и элементы окна адресуются
+     *  смещениями от него, поэтому соседние окна не требуют отдельных итераторов и отдельных проверок конца.
+     */
+    template <size_t N, typename Iterator>
+    class AdjacentGenerator {
+    public:
+        explicit AdjacentGenerator(Iterator first) : first_(first) {}
+
+        inline auto operator()(size_t index) const {
+            return Window(index, std::make_index_sequence<N>{});
+        }
+
+    private:
+        using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+        using value_type = RepeatedTupleT<decltype(*std::declval<Iterator>()), N>;
+
+        template <size_t... Indexes>
+        inline value_type Window(size_t index, std::index_sequence<Indexes...>) const {
+            return value_type(*(first_ + static_cast<difference_type>(index + Indexes))...);
+        }
+
+        Iterator first_;
+    };
+
+    // Окна многопроходного диапазона без произвольного доступа: итератор хранит итераторы на N элементов окна.
+    template <size_t N, typename Iterator>
+    class AdjacentForward {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = RepeatedTupleT<decltype(*std::declval<Iterator>()), N>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            iterator() = default;
+            explicit iterator(const std::array<Iterator, N>& window) : window_(window) {}
+
+            inline value_type operator*() const { return Dereference(std::make_index_sequence<N>{}); }
+
+            iterator& operator++() {
+                for (size_t k = 0; k + 1 < N; ++k)
+                    window_[k] = window_[k + 1];
+                ++window_[N - 1];
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+
+            // Окна сравниваются по последнему элементу: у итератора end() он совпадает с концом диапазона.
+            inline bool operator==(const iterator& other) const { return window_[N - 1] == other.window_[N - 1]; }
+            inline bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            template <size_t... Indexes>
+            inline value_type Dereference(std::index_sequence<Indexes...>) const {
+                // Копии итераторов разыменовываются и для итераторов Zip, operator* которых не константный.
+                return value_type(*Iterator(window_[Indexes])...);
+            }
+
+            std::array<Iterator, N> window_;
+        };
+
+        AdjacentForward(Iterator first, Iterator last) {
+            begin_[0] = first;
+            for (size_t k = 1; k < N; ++k) {
+                begin_[k] = begin_[k - 1];
+                if (begin_[k] != last)
+                    ++begin_[k];
+            }
+            end_[N - 1] = last;
+        }
+
+        inline iterator begin() const { return iterator(begin_); }
+        inline iterator end() const { return iterator(end_); }
+
+    private:
+        std::array<Iterator, N> begin_;
+        std::array<Iterator, N> end_;
+    };
+
+    /* Окна однопроходного диапазона (например, потока или генератора): последние N значений копируются в кольцевой
+     *  буфер, и строки - кортежи константных ссылок на его элементы, действительные до следующего перехода.
+     * Состояние хранится в объекте диапазона, поэтому все копии итератора разделяют его, как и положено итераторам ввода.
+     */
+    template <size_t N, typename Iterator>
+    class AdjacentInput {
+        using element_type = typename WindowValue<typename std::iterator_traits<Iterator>::value_type>::type;
+
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = RepeatedTupleT<const element_type&, N>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            iterator() = default;
+            explicit iterator(AdjacentInput* range) : range_(range) {}
+
+            inline value_type operator*() const { return Dereference(std::make_index_sequence<N>{}); }
+
+            iterator& operator++() {
+                range_->Advance();
+                return *this;
+            }
+
+            void operator++(int) { ++(*this); }
+
+            bool operator==(const iterator& other) const { return Done() == other.Done(); }
+            bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            inline bool Done() const { return range_ == nullptr || range_->done_; }
+
+            template <size_t... Indexes>
+            inline value_type Dereference(std::index_sequence<Indexes...>) const {
+                const auto& window = range_->window_;
+                size_t head = range_->head_;
+                return value_type(window[(head + Indexes) % N]...);
+            }
+
+            AdjacentInput* range_ = nullptr;
+        };
+
+        AdjacentInput(Iterator first, Iterator last) : it_(std::move(first)), end_(std::move(last)) {}
+
+        // Первый вызов читает первые N значений, последующие возвращают текущую позицию.
+        iterator begin() {
+            if (!started_) {
+                started_ = true;
+                window_.reserve(N);
+                for (; window_.size() < N && it_ != end_; ++it_)
+                    window_.push_back(element_type(*it_));
+                done_ = window_.size() < N;
+            }
+            return iterator(this);
+        }
+
+        iterator end() { return iterator(); }
+
+    private:
+        void Advance() {
+            if (it_ == end_) {
+                done_ = true;
+                return;
+            }
+            window_[head_] = element_type(*it_);
+            ++it_;
+            head_ = (head_ + 1) % N;
+        }
+
+        Iterator it_;
+        Iterator end_;
+        std::vector<element_type> window_;
+        size_t head_ = 0;
+        bool started_ = false;
+        bool done_ = false;
+    };
+
+    template <size_t N, typename Range>
+    auto AdjacentOf(Range&& range) {
+        static_assert(N != 0, "adjacent<N> requires N > 0");
+        auto first = std::begin(range);
+        auto last = std::end(range);
+        using Iterator = decltype(first);
+        using Category = typename std::iterator_traits<Iterator>::iterator_category;
+        if constexpr (std::is_convertible_v<Category, std::random_access_iterator_tag>) {
+            size_t size = static_cast<size_t>(last - first);
+            size_t windows = size >= N ? size - N + 1 : 0;
+            if constexpr (IsContiguousIterator<Iterator>::value) {
+                using Generator = AdjacentGenerator<N, decltype(std::addressof(*first))>;
+                return IndexedRange<Generator>(Generator(size != 0 ? std::addressof(*first) : nullptr), windows);
+            } else {
+                using Generator = AdjacentGenerator<N, Iterator>;
+                return IndexedRange<Generator>(Generator(first), windows);
+            }
+        } else if constexpr (std::is_convertible_v<Category, std::forward_iterator_tag>) {
+            return AdjacentForward<N, Iterator>(first, last);
+        } else {
+            return AdjacentInput<N, Iterator>(first, last);
+        }
+    }
+}
+
+
+namespace zipcpp {
+    /* Скользящие окна из N последовательных элементов: for (auto [prev, next] : zipcpp::adjacent<2>(v)) перебирает пары
+     *  соседних элементов, а диапазон из k элементов дает max(k - N + 1, 0) окон.
+     * Для диапазонов с произвольным доступом результат - диапазон с произвольным доступом, хранящий один итератор
+     *  (для непрерывной памяти - указатель), а строки - кортежи ссылок на элементы. Для многопроходных диапазонов
+     *  строки - кортежи ссылок, а для однопроходных (потоки, генераторы) - константных ссылок на копии последних N значений.
+     * Диапазон должен существовать во время обхода.
+     */
+    template <size_t N, typename Range>
+    auto adjacent(Range&& range) {
+        return zip_impl::AdjacentOf<N>(std::forward<Range>(range));
+    }
+
+    // То же, что adjacent<N>(zip(ranges...)): строки - кортежи из N последовательных строк zip(ranges...).
+    template <size_t N, typename... Ranges>
+    auto adjacent_zip(Ranges&&... ranges) {
+        return zip_impl::AdjacentOf<N>(zip(std::forward<Ranges>(ranges)...));
+    }
+}
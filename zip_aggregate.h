@@ -0,0 +1,260 @@
+#pragma once
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "zip.h"
+#include "zip_reduce.h"
+
+namespace zip_impl {
+
+    template <typename Row, typename KeyColumns, typename... Ops>
+    class AggregateTable;
+
+    /* Хеш-таблица с открытой адресацией, хранящая для каждой группы ключ и состояния агрегатов.
+     * Ячейки таблицы содержат только хеш и номер группы, а ключи, хеши и состояния каждого агрегата
+     *  хранятся в отдельных массивах (SoA), поэтому обновление агрегата затрагивает только его массив.
+     */
+    template <typename Row, size_t... KeyColumns, typename... Ops>
+    class AggregateTable<Row, std::index_sequence<KeyColumns...>, Ops...> {
+    public:
+        using key_type = std::tuple<std::decay_t<decltype(get<KeyColumns>(std::declval<const Row&>()))>...>;
+        using states_type = std::tuple<std::vector<decltype(std::declval<const Ops&>().init(std::declval<const Row&>()))>...>;
+
+        explicit AggregateTable(const std::tuple<Ops...>& ops) : ops_(ops) {
+            Rehash(16);
+        }
+
+        void Add(const Row& row) {
+            Tuple<decltype(get<KeyColumns>(row))...> key(get<KeyColumns>(row)...);
+            size_t hash = MixHash(std::hash<decltype(key)>{}(key));
+            size_t pos = FindSlot(hash, key);
+            if (slots_[pos].group != npos) {
+                UpdateStates(slots_[pos].group, row, std::index_sequence_for<Ops...>{});
+                return;
+            }
+            pos = Reserve(pos, hash, key);
+            slots_[pos] = Slot{hash, keys_.size()};
+            keys_.emplace_back(get<KeyColumns>(row)...);
+            hashes_.push_back(hash);
+            InitStates(row, std::index_sequence_for<Ops...>{});
+        }
+
+        // Объединяет группы другой таблицы с этой. Если parts > 1, учитываются только группы,
+        //  хеш которых попадает в часть с номером part.
+        void Merge(const AggregateTable& other, size_t part = 0, size_t parts = 1) {
+            for (size_t group = 0; group < other.keys_.size(); ++group) {
+                size_t hash = other.hashes_[group];
+                if (parts > 1 && PartitionOf(hash, parts) != part)
+                    continue;
+                size_t pos = FindSlot(hash, other.keys_[group]);
+                if (slots_[pos].group != npos) {
+                    MergeStates(slots_[pos].group, other, group, std::index_sequence_for<Ops...>{});
+                    continue;
+                }
+                pos = Reserve(pos, hash, other.keys_[group]);
+                slots_[pos] = Slot{hash, keys_.size()};
+                keys_.push_back(other.keys_[group]);
+                hashes_.push_back(hash);
+                CopyStates(other, group, std::index_sequence_for<Ops...>{});
+            }
+        }
+
+        /* Объединяет таблицы с непересекающимися множествами ключей (например, собранные из разных частей пространства
+         *  хешей): массивы ключей, хешей и состояний дописываются друг за другом, а ячейки строятся один раз
+         *  по сохраненным хешам без повторного вычисления хешей и сравнения ключей.
+         */
+        static AggregateTable Concatenate(std::vector<AggregateTable>&& tables) {
+            size_t groups = 0;
+            for (const auto& table : tables)
+                groups += table.keys_.size();
+            AggregateTable result = std::move(tables[0]);
+            result.keys_.reserve(groups);
+            result.hashes_.reserve(groups);
+            result.ReserveStates(groups, std::index_sequence_for<Ops...>{});
+            for (size_t index = 1; index < tables.size(); ++index) {
+                auto& table = tables[index];
+                result.keys_.insert(result.keys_.end(), std::make_move_iterator(table.keys_.begin()),
+                                    std::make_move_iterator(table.keys_.end()));
+                result.hashes_.insert(result.hashes_.end(), table.hashes_.begin(), table.hashes_.end());
+                result.AppendStates(table, std::index_sequence_for<Ops...>{});
+            }
+            size_t capacity = result.slots_.size();
+            while (capacity < 2 * groups)
+                capacity *= 2;
+            result.Rehash(capacity);
+            return result;
+        }
+
+        static size_t PartitionOf(size_t hash, size_t parts) {
+            return (hash >> (sizeof(size_t) * 4)) % parts;
+        }
+
+        inline size_t size() const { return keys_.size(); }
+        inline const std::vector<key_type>& keys() const { return keys_; }
+
+        template <size_t Index>
+        inline const auto& states() const { return std::get<Index>(states_); }
+
+        // Объект Zip по ключам и состояниям агрегатов: каждая строка - кортеж (ключ, состояния...).
+        auto rows() const {
+            return RowsImpl(std::index_sequence_for<Ops...>{});
+        }
+
+    private:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        struct Slot {
+            size_t hash;
+            size_t group;
+        };
+
+        template <typename Key>
+        size_t FindSlot(size_t hash, const Key& key) const {
+            size_t pos = hash & mask_;
+            while (slots_[pos].group != npos && !(slots_[pos].hash == hash && keys_[slots_[pos].group] == key))
+                pos = (pos + 1) & mask_;
+            return pos;
+        }
+
+        // Увеличивает таблицу перед добавлением группы, если она заполнена наполовину, и возвращает новую свободную ячейку.
+        template <typename Key>
+        size_t Reserve(size_t pos, size_t hash, const Key& key) {
+            if (2 * (keys_.size() + 1) <= slots_.size())
+                return pos;
+            Rehash(2 * slots_.size());
+            return FindSlot(hash, key);
+        }
+
+        void Rehash(size_t capacity) {
+            slots_.assign(capacity, Slot{0, npos});
+            mask_ = capacity - 1;
+            for (size_t group = 0; group < hashes_.size(); ++group) {
+                size_t pos = hashes_[group] & mask_;
+                while (slots_[pos].group != npos)
+                    pos = (pos + 1) & mask_;
+                slots_[pos] = Slot{hashes_[group], group};
+            }
+        }
+
+        template <size_t... Indexes>
+        inline void InitStates(const Row& row, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(states_).push_back(std::get<Indexes>(ops_).init(row)), ...);
+        }
+
+        template <size_t... Indexes>
+        inline void UpdateStates(size_t group, const Row& row, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(ops_).update(std::get<Indexes>(states_)[group], row), ...);
+        }
+
+        template <size_t... Indexes>
+        inline void MergeStates(size_t group, const AggregateTable& other, size_t other_group, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(ops_).merge(std::get<Indexes>(states_)[group], std::get<Indexes>(other.states_)[other_group]), ...);
+        }
+
+        template <size_t... Indexes>
+        inline void CopyStates(const AggregateTable& other, size_t other_group, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(states_).push_back(std::get<Indexes>(other.states_)[other_group]), ...);
+        }
+
+        template <size_t... Indexes>
+        inline void ReserveStates(size_t groups, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(states_).reserve(groups), ...);
+        }
+
+        template <size_t... Indexes>
+        inline void AppendStates(AggregateTable& other, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(states_).insert(std::get<Indexes>(states_).end(),
+                                               std::make_move_iterator(std::get<Indexes>(other.states_).begin()),
+                                               std::make_move_iterator(std::get<Indexes>(other.states_).end())), ...);
+        }
+
+        template <size_t... Indexes>
+        auto RowsImpl(std::index_sequence<Indexes...>) const {
+            return zipcpp::zip(keys_, std::get<Indexes>(states_)...);
+        }
+
+        std::tuple<Ops...> ops_;
+        std::vector<Slot> slots_;
+        size_t mask_ = 0;
+        std::vector<key_type> keys_;
+        std::vector<size_t> hashes_;
+        states_type states_;
+    };
+
+    template <typename ZipType, size_t... KeyColumns, typename... Ops>
+    auto MakeAggregateTable(std::index_sequence<KeyColumns...>, const std::tuple<Ops...>& ops) {
+        using Row = typename std::iterator_traits<decltype(std::begin(std::declval<ZipType&>()))>::value_type;
+        return AggregateTable<Row, std::index_sequence<KeyColumns...>, Ops...>(ops);
+    }
+}
+
+
+namespace zipcpp {
+    /* Агрегация строк объекта Zip по значениям столбцов KeyColumns при помощи агрегатов из zip_reduce.h.
+     * Возвращает таблицу групп: keys() - вектор ключей, states<I>() - вектор состояний I-го агрегата,
+     *  rows() - объект Zip по ключам и состояниям. Группы перечисляются в порядке первого появления ключа.
+     */
+    template <size_t... KeyColumns, typename ZipType, typename... Ops>
+    auto hash_aggregate(ZipType&& rows, Ops... ops) {
+        auto table = zip_impl::MakeAggregateTable<std::remove_reference_t<ZipType>>(
+                std::index_sequence<KeyColumns...>{}, std::make_tuple(std::move(ops)...));
+        for (auto&& row : rows)
+            table.Add(row);
+        return table;
+    }
+
+    /* Параллельный вариант hash_aggregate для объектов Zip с произвольным доступом.
+     * Диапазон делится на threads частей, каждая из которых агрегируется в отдельную локальную таблицу,
+     *  после чего локальные таблицы объединяются: каждый поток собирает группы своей части пространства хешей,
+     *  а затем таблицы частей соединяются без повторного хеширования.
+     * Порядок групп в результате не определен.
+     */
+    template <size_t... KeyColumns, typename ZipType, typename... Ops>
+    auto hash_aggregate_parallel(ZipType&& rows, size_t threads, Ops... ops) {
+        auto first = std::begin(rows);
+        static_assert(std::is_convertible_v<typename decltype(first)::iterator_category, std::random_access_iterator_tag>);
+        auto all_ops = std::make_tuple(std::move(ops)...);
+        auto make_table = [&all_ops] {
+            return zip_impl::MakeAggregateTable<std::remove_reference_t<ZipType>>(std::index_sequence<KeyColumns...>{}, all_ops);
+        };
+        if (threads <= 1) {
+            auto table = make_table();
+            for (auto&& row : rows)
+                table.Add(row);
+            return table;
+        }
+
+        size_t size = rows.size();
+        std::vector<decltype(make_table())> locals(threads, make_table());
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t part = 0; part < threads; ++part) {
+            workers.emplace_back([&, part] {
+                auto it = first + static_cast<int>(size * part / threads);
+                auto last = first + static_cast<int>(size * (part + 1) / threads);
+                for (; it != last; ++it)
+                    locals[part].Add(*it);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        std::vector<decltype(make_table())> merged(threads, make_table());
+        workers.clear();
+        for (size_t part = 0; part < threads; ++part) {
+            workers.emplace_back([&, part] {
+                for (const auto& local : locals)
+                    merged[part].Merge(local, part, threads);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        // Части пространства хешей не пересекаются, поэтому их группы объединяются без поиска в хеш-таблице.
+        return decltype(make_table())::Concatenate(std::move(merged));
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "zip.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ZIPCPP_HAS_SSE2 1
+#endif
+
+/* Поиск первого различия строк двух объектов Zip и первой строки, удовлетворяющей условию.
+ * Для столбцов в непрерывной памяти с арифметическими значениями строки обрабатываются блоками: столбцы сравниваются
+ *  по отдельности векторными инструкциями, и только затем определяется номер первой отличающейся строки.
+ */
+
+namespace zip_impl {
+    // Количество строк, которые сравниваются по всем столбцам, прежде чем перейти к следующему блоку.
+    inline constexpr size_t kCompareBlockRows = 1024;
+    // Количество строк, для которых условие find_if_row вычисляется без ветвлений перед проверкой результата.
+    inline constexpr size_t kFindBlockRows = 64;
+
+#if defined(ZIPCPP_HAS_SSE2)
+    // Значения, которые сравниваются векторными инструкциями: целые числа - побайтно, float и double - как оператором ==
+    //  (NaN не равно себе, 0.0 == -0.0).
+    template <typename T>
+    inline constexpr bool kSimdComparable = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+            || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+    // Байты результата сравнения 16 байтов a и b: 0xFF для байтов равных значений.
+    template <typename T>
+    inline __m128i EqualBytes(const unsigned char* a, const unsigned char* b) {
+        if constexpr (std::is_same_v<T, float>) {
+            return _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(reinterpret_cast<const float*>(a)),
+                                                 _mm_loadu_ps(reinterpret_cast<const float*>(b))));
+        } else if constexpr (std::is_same_v<T, double>) {
+            return _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(reinterpret_cast<const double*>(a)),
+                                                 _mm_loadu_pd(reinterpret_cast<const double*>(b))));
+        } else {
+            return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        }
+    }
+#endif
+
+    // Номер первого отличающегося элемента массивов a и b длины count или count, если массивы совпадают.
+    // Векторный цикл проверяет по 64 байта за одно ветвление, а отличающиеся 16 байтов ищутся только после него.
+    template <typename T>
+    size_t FirstMismatch(const T* a, const T* b, size_t count) {
+        size_t i = 0;
+#if defined(ZIPCPP_HAS_SSE2)
+        if constexpr (kSimdComparable<T>) {
+            const unsigned char* x = reinterpret_cast<const unsigned char*>(a);
+            const unsigned char* y = reinterpret_cast<const unsigned char*>(b);
+            size_t bytes = count * sizeof(T);
+            size_t k = 0;
+            for (; k + 64 <= bytes; k += 64) {
+                __m128i equal = _mm_and_si128(_mm_and_si128(EqualBytes<T>(x + k, y + k), EqualBytes<T>(x + k + 16, y + k + 16)),
+                                              _mm_and_si128(EqualBytes<T>(x + k + 32, y + k + 32), EqualBytes<T>(x + k + 48, y + k + 48)));
+                if (_mm_movemask_epi8(equal) != 0xFFFF)
+                    break;
+            }
+            for (; k + 16 <= bytes; k += 16) {
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(EqualBytes<T>(x + k, y + k))) ^ 0xFFFFu;
+                if (mask != 0)
+                    return (k + CountTrailingZeros(mask)) / sizeof(T);
+            }
+            i = k / sizeof(T);
+        }
+#endif
+        for (; i < count; ++i) {
+            if (!(a[i] == b[i]))
+                return i;
+        }
+        return count;
+    }
+
+    template <typename Iterator>
+    using ContiguousValue = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<Iterator>())>>;
+
+    template <typename A, typename B>
+    struct ComparableColumns : public std::false_type {};
+
+    template <typename ColumnsA, typename ColumnsB, typename = void>
+    struct ComparableColumnTypes : public std::false_type {};
+
+    template <typename... ItersA, typename... ItersB>
+    struct ComparableColumnTypes<std::tuple<ItersA...>, std::tuple<ItersB...>, std::enable_if_t<sizeof...(ItersA) == sizeof...(ItersB)>>
+            : public std::conjunction<IsContiguousIterator<ItersA>..., IsContiguousIterator<ItersB>...,
+                                      std::is_same<ContiguousValue<ItersA>, ContiguousValue<ItersB>>...,
+                                      std::is_arithmetic<ContiguousValue<ItersA>>...> {};
+
+    // Оба объекта Zip состоят из столбцов в непрерывной памяти с попарно совпадающими арифметическими типами значений.
+    template <typename... ItersA, typename... ItersB>
+    struct ComparableColumns<ZipIterator<ItersA...>, ZipIterator<ItersB...>>
+            : public ComparableColumnTypes<std::tuple<ItersA...>, std::tuple<ItersB...>> {};
+
+    template <typename... ItersA, typename B>
+    struct ComparableColumns<ConstZipIterator<ItersA...>, B> : public ComparableColumns<ZipIterator<ItersA...>, B> {};
+
+    template <typename... ItersA, typename... ItersB>
+    struct ComparableColumns<ZipIterator<ItersA...>, ConstZipIterator<ItersB...>>
+            : public ComparableColumns<ZipIterator<ItersA...>, ZipIterator<ItersB...>> {};
+
+    // Номер первой отличающейся строки среди первых count строк: каждый блок строк сравнивается по столбцам,
+    //  и следующий столбец блока сравнивается только до уже найденного различия.
+    template <typename IteratorA, typename IteratorB, size_t... Indexes>
+    size_t FirstMismatchingRow(IteratorA a, IteratorB b, size_t count, std::index_sequence<Indexes...>) {
+        if (count == 0)
+            return 0;
+        auto columns_a = std::make_tuple(std::addressof(*std::get<Indexes>(a.AsTuple()))...);
+        auto columns_b = std::make_tuple(std::addressof(*std::get<Indexes>(b.AsTuple()))...);
+        for (size_t first = 0; first < count; first += kCompareBlockRows) {
+            size_t limit = std::min(kCompareBlockRows, count - first);
+            ((limit = FirstMismatch(std::get<Indexes>(columns_a) + first, std::get<Indexes>(columns_b) + first, limit)), ...);
+            if (limit != std::min(kCompareBlockRows, count - first))
+                return first + limit;
+        }
+        return count;
+    }
+
+    template <typename RangeA, typename RangeB>
+    auto Mismatch(RangeA& a, RangeB& b) {
+        auto first_a = std::begin(a);
+        auto first_b = std::begin(b);
+        using IteratorA = decltype(first_a);
+        using IteratorB = decltype(first_b);
+        if constexpr (ComparableColumns<IteratorA, IteratorB>::value) {
+            using difference_type = typename std::iterator_traits<IteratorA>::difference_type;
+            size_t count = std::min<size_t>(std::end(a) - first_a, std::end(b) - first_b);
+            size_t row = FirstMismatchingRow(first_a, first_b, count,
+                                             std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(first_a.AsTuple())>>>{});
+            return std::make_pair(first_a + static_cast<difference_type>(row), first_b + static_cast<difference_type>(row));
+        } else {
+            auto last_a = std::end(a);
+            auto last_b = std::end(b);
+            while (first_a != last_a && first_b != last_b && *first_a == *first_b) {
+                ++first_a;
+                ++first_b;
+            }
+            return std::make_pair(first_a, first_b);
+        }
+    }
+
+    template <typename Iterator>
+    struct ContiguousRows : public std::false_type {};
+
+    template <typename... Iters>
+    struct ContiguousRows<ZipIterator<Iters...>> : public std::conjunction<IsContiguousIterator<Iters>...> {};
+
+    template <typename... Iters>
+    struct ContiguousRows<ConstZipIterator<Iters...>> : public ContiguousRows<ZipIterator<Iters...>> {};
+
+    /* Условие вычисляется для блока из kFindBlockRows строк без досрочного выхода, и строки составляются из указателей
+     *  на элементы столбцов, поэтому компилятор может векторизовать цикл; первая подходящая строка ищется только
+     *  в блоке, где условие выполнилось.
+     */
+    template <typename Iterator, typename Predicate, size_t... Indexes>
+    size_t FindRow(const Iterator& first, size_t count, Predicate& pred, std::index_sequence<Indexes...>) {
+        if (count == 0)
+            return 0;
+        using Row = typename std::iterator_traits<Iterator>::value_type;
+        auto columns = std::make_tuple(std::addressof(*std::get<Indexes>(first.AsTuple()))...);
+        auto matches = [&](size_t row) { return static_cast<bool>(pred(Row(std::get<Indexes>(columns)[row]...))); };
+        size_t block = 0;
+        for (; block + kFindBlockRows <= count; block += kFindBlockRows) {
+            // Постоянное число итераций и сумма вместо логического ИЛИ позволяют векторизовать цикл уже при -O2.
+            unsigned found = 0;
+            for (size_t row = 0; row < kFindBlockRows; ++row)
+                found += matches(block + row);
+            if (found != 0)
+                break;
+        }
+        for (size_t row = block; row < count; ++row) {
+            if (matches(row))
+                return row;
+        }
+        return count;
+    }
+}
+
+
+namespace zipcpp {
+    /* Первая пара различающихся строк двух диапазонов, как std::mismatch(a.begin(), a.end(), b.begin(), b.end()):
+     *  возвращается пара итераторов, и если различий среди первых min(size(a), size(b)) строк нет, то один из итераторов -
+     *  конец своего диапазона.
+     * Если оба диапазона - объекты Zip из столбцов в непрерывной памяти с одинаковыми арифметическими типами значений,
+     *  то строки сравниваются блоками по столбцам: целые числа - побайтно инструкциями SSE2, float и double - векторным
+     *  сравнением с результатом оператора ==. Иначе строки сравниваются по очереди оператором ==.
+     */
+    template <typename RangeA, typename RangeB>
+    auto mismatch(RangeA&& a, RangeB&& b) {
+        return zip_impl::Mismatch(a, b);
+    }
+
+    // Диапазоны имеют одинаковую длину и попарно равные строки; сравнение выполняется так же, как в mismatch.
+    template <typename RangeA, typename RangeB>
+    bool equal(RangeA&& a, RangeB&& b) {
+        auto [it_a, it_b] = zip_impl::Mismatch(a, b);
+        return it_a == std::end(a) && it_b == std::end(b);
+    }
+
+    /* Итератор на первую строку, для которой pred(row) истинно, или конец диапазона.
+     * Для объектов Zip из столбцов в непрерывной памяти условие вычисляется блоками по 64 строки без ветвлений,
+     *  поэтому оно может вызываться и для строк после найденной в пределах блока и не должно иметь побочных эффектов.
+     */
+    template <typename Range, typename Predicate>
+    auto find_if_row(Range&& range, Predicate pred) {
+        auto first = std::begin(range);
+        using Iterator = decltype(first);
+        if constexpr (zip_impl::ContiguousRows<Iterator>::value) {
+            using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+            size_t count = static_cast<size_t>(std::end(range) - first);
+            size_t row = zip_impl::FindRow(first, count, pred,
+                                           std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(first.AsTuple())>>>{});
+            return first + static_cast<difference_type>(row);
+        } else {
+            auto last = std::end(range);
+            for (; first != last; ++first) {
+                if (pred(*first))
+                    break;
+            }
+            return first;
+        }
+    }
+}
@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "zip.h"
+
+/* Сжатые столбцы, которые передаются в zip без распаковки в вектор:
+ *  delta_column<T> - разности соседних целых чисел (например, отметок времени) в кодировке переменной длины,
+ *  rle_column<T> - серии повторяющихся значений (например, статусов),
+ *  dict_column<T> - номера значений в словаре (например, строк).
+ * Итераторы - итераторы с произвольным доступом, поэтому объект Zip со сжатыми столбцами можно сдвигать через +=,
+ *  и сдвиг пропускает целые блоки и серии без распаковки.
+ */
+
+namespace zip_impl {
+    // Количество значений delta_column, распаковываемых за один раз; буфер блока помещается в кэш первого уровня.
+    inline constexpr size_t kColumnBlockSize = 128;
+    inline constexpr size_t kNoBlock = static_cast<size_t>(-1);
+
+    template <typename U>
+    inline void PutVarint(std::vector<uint8_t>& bytes, U value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    template <typename U>
+    inline const uint8_t* GetVarint(const uint8_t* bytes, U& value) {
+        // Малые разности (например, соседних отметок времени) занимают один байт.
+        if (*bytes < 0x80) {
+            value = *bytes;
+            return bytes + 1;
+        }
+        value = *bytes & 0x7F;
+        for (unsigned shift = 7; *bytes++ & 0x80; shift += 7)
+            value |= static_cast<U>(*bytes & 0x7F) << shift;
+        return bytes;
+    }
+
+    // Отображение разности в беззнаковое число, в котором разности малой величины любого знака занимают мало битов.
+    template <typename U>
+    inline U ZigZag(U delta) {
+        constexpr unsigned kBits = sizeof(U) * 8 - 1;
+        return static_cast<U>((delta << 1) ^ static_cast<U>(0 - (delta >> kBits)));
+    }
+
+    template <typename U>
+    inline U UnZigZag(U value) {
+        return static_cast<U>((value >> 1) ^ static_cast<U>(0 - (value & 1)));
+    }
+
+    /* Итератор сжатого столбца: хранит номер элемента, а значение по номеру получает Decoder, который запоминает
+     *  положение последнего обращения (распакованный блок, текущую серию), поэтому последовательный обход не повторяет
+     *  поиск, а сдвиг на n элементов только меняет номер.
+     */
+    template <typename Decoder>
+    class CompressedIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename Decoder::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = typename Decoder::reference;
+
+        CompressedIterator() = default;
+        CompressedIterator(const typename Decoder::column_type* column, difference_type index) : decoder_(column), index_(index) {}
+
+        inline reference operator*() const { return decoder_.Get(static_cast<size_t>(index_)); }
+        inline reference operator[](difference_type n) const { return decoder_.Get(static_cast<size_t>(index_ + n)); }
+
+        inline CompressedIterator& operator++() { ++index_; return *this; }
+        inline CompressedIterator operator++(int) { auto it = *this; ++index_; return it; }
+        inline CompressedIterator& operator--() { --index_; return *this; }
+        inline CompressedIterator operator--(int) { auto it = *this; --index_; return it; }
+        inline CompressedIterator& operator+=(difference_type n) { index_ += n; return *this; }
+        inline CompressedIterator& operator-=(difference_type n) { index_ -= n; return *this; }
+        inline CompressedIterator operator+(difference_type n) const { auto it = *this; it.index_ += n; return it; }
+        inline CompressedIterator operator-(difference_type n) const { auto it = *this; it.index_ -= n; return it; }
+        inline difference_type operator-(const CompressedIterator& other) const { return index_ - other.index_; }
+
+        inline bool operator==(const CompressedIterator& other) const { return index_ == other.index_; }
+        inline bool operator!=(const CompressedIterator& other) const { return index_ != other.index_; }
+        inline bool operator<(const CompressedIterator& other) const { return index_ < other.index_; }
+        inline bool operator>(const CompressedIterator& other) const { return index_ > other.index_; }
+        inline bool operator<=(const CompressedIterator& other) const { return index_ <= other.index_; }
+        inline bool operator>=(const CompressedIterator& other) const { return index_ >= other.index_; }
+
+    private:
+        mutable Decoder decoder_;
+        difference_type index_ = 0;
+    };
+
+    /* Распаковывает блок delta_column, содержащий запрошенный элемент, в буфер итератора. Копии итератора разделяют
+     *  буфер с уже распакованным блоком, поэтому копирование дешево и не требует повторной распаковки; копия, которой
+     *  нужен другой блок, пока буфер используется еще кем-то, распаковывает его в собственный буфер.
+     */
+    template <typename Column>
+    class DeltaDecoder {
+    public:
+        using column_type = Column;
+        using value_type = typename Column::value_type;
+        using reference = value_type;
+
+        DeltaDecoder() = default;
+        explicit DeltaDecoder(const Column* column) : column_(column) {}
+        DeltaDecoder(const DeltaDecoder&) = default;
+
+        DeltaDecoder(DeltaDecoder&& other) noexcept
+                : column_(other.column_), buffer_(std::move(other.buffer_)), block_(std::exchange(other.block_, kNoBlock)) {}
+
+        DeltaDecoder& operator=(const DeltaDecoder&) = default;
+
+        DeltaDecoder& operator=(DeltaDecoder&& other) noexcept {
+            column_ = other.column_;
+            buffer_ = std::move(other.buffer_);
+            block_ = std::exchange(other.block_, kNoBlock);
+            return *this;
+        }
+
+        inline value_type Get(size_t index) {
+            size_t block = index / kColumnBlockSize;
+            if (block != block_)
+                Decode(block);
+            return (*buffer_)[index % kColumnBlockSize];
+        }
+
+    private:
+        void Decode(size_t block) {
+            if (!buffer_ || buffer_.use_count() > 1)
+                buffer_ = std::make_shared<std::array<value_type, kColumnBlockSize>>();
+            column_->decode_block(block, buffer_->data());
+            block_ = block;
+        }
+
+        const Column* column_ = nullptr;
+        std::shared_ptr<std::array<value_type, kColumnBlockSize>> buffer_;
+        size_t block_ = kNoBlock;
+    };
+
+    // Запоминает текущую серию rle_column: следующий элемент находится в ней же или в следующей серии,
+    //  а при сдвиге за их пределы серия ищется двоичным поиском по концам серий.
+    template <typename Column>
+    class RunDecoder {
+    public:
+        using column_type = Column;
+        using value_type = typename Column::value_type;
+        using reference = const value_type&;
+
+        RunDecoder() = default;
+        explicit RunDecoder(const Column* column) : column_(column) {}
+
+        inline reference Get(size_t index) {
+            // Одно беззнаковое сравнение проверяет обе границы текущей серии.
+            if (index - first_ >= last_ - first_)
+                Find(index);
+            return column_->values_[run_];
+        }
+
+    private:
+        void Find(size_t index) {
+            const auto& ends = column_->ends_;
+            if (last_ != 0 && index >= last_ && run_ + 1 < ends.size() && index < ends[run_ + 1])
+                ++run_;
+            else
+                run_ = static_cast<size_t>(std::upper_bound(ends.begin(), ends.end(), index) - ends.begin());
+            first_ = run_ != 0 ? ends[run_ - 1] : 0;
+            last_ = ends[run_];
+        }
+
+        const Column* column_ = nullptr;
+        size_t run_ = 0;
+        // Номера первого элемента текущей серии и элемента после нее; пустая серия до первого обращения.
+        size_t first_ = 0;
+        size_t last_ = 0;
+    };
+
+    template <typename Column>
+    class DictionaryDecoder {
+    public:
+        using column_type = Column;
+        using value_type = typename Column::value_type;
+        using reference = const value_type&;
+
+        DictionaryDecoder() = default;
+        explicit DictionaryDecoder(const Column* column) : column_(column) {}
+
+        inline reference Get(size_t index) const { return column_->dictionary_[column_->codes_[index]]; }
+
+    private:
+        const Column* column_ = nullptr;
+    };
+}
+
+
+namespace zipcpp {
+    /* Столбец целых чисел, хранящий разности соседних значений в кодировке переменной длины (ZigZag + varint).
+     * Значения разбиты на блоки по 128, для каждого блока хранятся первое значение и смещение его разностей, поэтому
+     *  итератор распаковывает в свой буфер только текущий блок, а сдвиг через += переходит сразу к нужному блоку.
+     * Итераторы возвращают значения, а не ссылки, и действительны, пока существует столбец и в него не добавляются значения.
+     */
+    template <typename T>
+    class delta_column {
+        static_assert(std::is_integral_v<T>, "delta_column requires an integral value type");
+        using unsigned_type = std::make_unsigned_t<T>;
+
+    public:
+        using value_type = T;
+        using iterator = zip_impl::CompressedIterator<zip_impl::DeltaDecoder<delta_column>>;
+        using const_iterator = iterator;
+
+        delta_column() = default;
+
+        template <typename Range>
+        explicit delta_column(const Range& values) {
+            for (const auto& value : values)
+                push_back(static_cast<T>(value));
+        }
+
+        void push_back(T value) {
+            if (size_ % zip_impl::kColumnBlockSize == 0) {
+                bases_.push_back(value);
+                offsets_.push_back(bytes_.size());
+            } else {
+                auto delta = static_cast<unsigned_type>(static_cast<unsigned_type>(value) - static_cast<unsigned_type>(last_));
+                zip_impl::PutVarint(bytes_, zip_impl::ZigZag(delta));
+            }
+            last_ = value;
+            ++size_;
+        }
+
+        inline size_t size() const { return size_; }
+        inline bool empty() const { return size_ == 0; }
+        inline size_t blocks() const { return bases_.size(); }
+        // Размер сжатых данных в байтах.
+        inline size_t encoded_bytes() const { return bytes_.size() + bases_.size() * (sizeof(T) + sizeof(size_t)); }
+
+        inline iterator begin() const { return iterator(this, 0); }
+        inline iterator end() const { return iterator(this, static_cast<std::ptrdiff_t>(size_)); }
+
+        // Распаковывает блок с номером block (до 128 значений) в out; возвращает количество значений.
+        size_t decode_block(size_t block, T* out) const {
+            size_t count = std::min(zip_impl::kColumnBlockSize, size_ - block * zip_impl::kColumnBlockSize);
+            const uint8_t* bytes = bytes_.data() + offsets_[block];
+            auto value = static_cast<unsigned_type>(bases_[block]);
+            out[0] = bases_[block];
+            for (size_t i = 1; i < count; ++i) {
+                unsigned_type delta;
+                bytes = zip_impl::GetVarint(bytes, delta);
+                value = static_cast<unsigned_type>(value + zip_impl::UnZigZag(delta));
+                out[i] = static_cast<T>(value);
+            }
+            return count;
+        }
+
+    private:
+        std::vector<uint8_t> bytes_;
+        std::vector<T> bases_;
+        std::vector<size_t> offsets_;
+        size_t size_ = 0;
+        T last_ = T();
+    };
+
+    template <typename Range>
+    delta_column(const Range&) -> delta_column<typename std::iterator_traits<decltype(std::begin(std::declval<const Range&>()))>::value_type>;
+
+    /* Столбец из серий одинаковых значений: хранятся значения серий и номера элементов, следующих за каждой серией.
+     * Итераторы возвращают ссылки на значения серий; последовательный обход переходит к следующей серии
+     *  без поиска, а сдвиг через += находит серию двоичным поиском, не перебирая пропущенные серии.
+     */
+    template <typename T>
+    class rle_column {
+    public:
+        using value_type = T;
+        using iterator = zip_impl::CompressedIterator<zip_impl::RunDecoder<rle_column>>;
+        using const_iterator = iterator;
+
+        rle_column() = default;
+
+        template <typename Range>
+        explicit rle_column(const Range& values) {
+            for (const auto& value : values)
+                push_back(value);
+        }
+
+        // Добавляет count копий value; равные соседние значения объединяются в одну серию.
+        void push_back(const T& value, size_t count = 1) {
+            if (count == 0)
+                return;
+            if (!values_.empty() && values_.back() == value) {
+                ends_.back() += count;
+            } else {
+                values_.push_back(value);
+                ends_.push_back(size() + count);
+            }
+        }
+
+        inline size_t size() const { return ends_.empty() ? 0 : ends_.back(); }
+        inline bool empty() const { return ends_.empty(); }
+        inline size_t runs() const { return values_.size(); }
+
+        inline iterator begin() const { return iterator(this, 0); }
+        inline iterator end() const { return iterator(this, static_cast<std::ptrdiff_t>(size())); }
+
+    private:
+        friend class zip_impl::RunDecoder<rle_column>;
+
+        std::vector<T> values_;
+        std::vector<size_t> ends_;
+    };
+
+    template <typename Range>
+    rle_column(const Range&) -> rle_column<typename std::iterator_traits<decltype(std::begin(std::declval<const Range&>()))>::value_type>;
+
+    /* Столбец номеров значений в словаре различных значений. Итераторы возвращают ссылки на элементы словаря,
+     *  поэтому обход не копирует значения (например, строки), а сдвиг через += только меняет номер элемента.
+     * Тип значений должен поддерживать std::hash для построения словаря.
+     */
+    template <typename T, typename Hash = std::hash<T>>
+    class dict_column {
+    public:
+        using value_type = T;
+        using iterator = zip_impl::CompressedIterator<zip_impl::DictionaryDecoder<dict_column>>;
+        using const_iterator = iterator;
+
+        dict_column() = default;
+
+        template <typename Range>
+        explicit dict_column(const Range& values) {
+            for (const auto& value : values)
+                push_back(value);
+        }
+
+        void push_back(const T& value) {
+            auto [it, inserted] = codes_of_.try_emplace(value, static_cast<uint32_t>(dictionary_.size()));
+            if (inserted)
+                dictionary_.push_back(value);
+            codes_.push_back(it->second);
+        }
+
+        inline size_t size() const { return codes_.size(); }
+        inline bool empty() const { return codes_.empty(); }
+        inline const std::vector<T>& dictionary() const { return dictionary_; }
+        inline const std::vector<uint32_t>& codes() const { return codes_; }
+
+        inline iterator begin() const { return iterator(this, 0); }
+        inline iterator end() const { return iterator(this, static_cast<std::ptrdiff_t>(size())); }
+
+    private:
+        friend class zip_impl::DictionaryDecoder<dict_column>;
+
+        std::vector<T> dictionary_;
+        std::vector<uint32_t> codes_;
+        std::unordered_map<T, uint32_t, Hash> codes_of_;
+    };
+
+    template <typename Range>
+    dict_column(const Range&) -> dict_column<typename std::iterator_traits<decltype(std::begin(std::declval<const Range&>()))>::value_type>;
+}
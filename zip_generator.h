@@ -0,0 +1,244 @@
+#pragma once
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "zip.h"
+
+/* Генератор на сопрограммах C++20, итераторы которого можно передавать в zip как итераторы ввода.
+ * При компиляции в C++17 этот файл ничего не объявляет.
+ */
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define ZIPCPP_HAS_GENERATOR 1
+#endif
+#endif
+
+#if defined(ZIPCPP_HAS_GENERATOR)
+
+namespace zip_impl {
+
+    /* Пул кадров сопрограмм текущего потока. Кадры округляются до классов размеров, кратных 64 байтам,
+     *  и после завершения генератора сохраняются в списке свободных блоков своего класса, поэтому
+     *  повторное создание генераторов того же типа не обращается к глобальному распределителю памяти.
+     */
+    class FramePool {
+    public:
+        static void* Allocate(size_t size) {
+            size_t bucket = BucketOf(size);
+            if (bucket >= kBuckets)
+                return ::operator new(size);
+            auto& blocks = Local().free[bucket];
+            if (blocks.empty())
+                return ::operator new(BucketSize(bucket));
+            void* block = blocks.back();
+            blocks.pop_back();
+            return block;
+        }
+
+        static void Deallocate(void* block, size_t size) {
+            size_t bucket = BucketOf(size);
+            if (bucket < kBuckets) {
+                auto& blocks = Local().free[bucket];
+                if (blocks.size() < kMaxCachedPerBucket) {
+                    blocks.push_back(block);
+                    return;
+                }
+            }
+            ::operator delete(block);
+        }
+
+        // Количество свободных блоков в пуле текущего потока.
+        static size_t Cached() {
+            size_t count = 0;
+            for (const auto& blocks : Local().free)
+                count += blocks.size();
+            return count;
+        }
+
+    private:
+        static constexpr size_t kGranularity = 64;
+        static constexpr size_t kBuckets = 64;
+        static constexpr size_t kMaxCachedPerBucket = 64;
+
+        struct Buckets {
+            std::vector<void*> free[kBuckets];
+
+            ~Buckets() {
+                for (auto& blocks : free)
+                    for (void* block : blocks)
+                        ::operator delete(block);
+            }
+        };
+
+        static inline size_t BucketOf(size_t size) { return (size + kGranularity - 1) / kGranularity; }
+        static inline size_t BucketSize(size_t bucket) { return bucket * kGranularity; }
+
+        static Buckets& Local() {
+            thread_local Buckets buckets;
+            return buckets;
+        }
+    };
+}
+
+
+namespace zipcpp {
+    // Несколько значений, возвращаемых одним co_yield. Данные должны существовать до следующего возобновления генератора.
+    template <typename T>
+    struct yield_batch {
+        const T* data;
+        size_t size;
+    };
+
+    template <typename T>
+    yield_batch<T> batch(const std::vector<T>& values) {
+        return {values.data(), values.size()};
+    }
+
+    template <typename T>
+    yield_batch<T> batch(const T* data, size_t size) {
+        return {data, size};
+    }
+
+    /* Ленивая последовательность значений типа T, вычисляемая сопрограммой:
+     *   zipcpp::generator<int> numbers() { for (int i = 0;; ++i) co_yield i; }
+     * Итераторы генератора являются итераторами ввода и могут передаваться в zip вместе с итераторами контейнеров:
+     *  обход zip(gen, values) завершается, когда заканчивается любая из последовательностей. Генератор передается в zip
+     *  по ссылке и должен существовать во время обхода.
+     * co_yield zipcpp::batch(values) возвращает сразу несколько значений: итератор перебирает их без возобновления
+     *  сопрограммы, что уменьшает накладные расходы на одно значение.
+     */
+    template <typename T>
+    class generator {
+    public:
+        struct promise_type {
+            const T* values = nullptr;
+            size_t count = 0;
+            size_t position = 0;
+            std::exception_ptr exception;
+
+            generator get_return_object() {
+                return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            std::suspend_always yield_value(const T& value) noexcept {
+                values = std::addressof(value);
+                count = 1;
+                position = 0;
+                return {};
+            }
+
+            std::suspend_always yield_value(yield_batch<T> batch) noexcept {
+                values = batch.data;
+                count = batch.size;
+                position = 0;
+                return {};
+            }
+
+            void return_void() noexcept {}
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            static void* operator new(size_t size) { return zip_impl::FramePool::Allocate(size); }
+            static void operator delete(void* frame, size_t size) { zip_impl::FramePool::Deallocate(frame, size); }
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        // Все копии итератора разделяют состояние генератора, как и положено итераторам ввода.
+        // Итератор, созданный конструктором по умолчанию, обозначает конец последовательности.
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            iterator() = default;
+            explicit iterator(handle_type handle) : handle_(handle) {}
+
+            reference operator*() const {
+                const auto& promise = handle_.promise();
+                return promise.values[promise.position];
+            }
+
+            pointer operator->() const { return std::addressof(**this); }
+
+            iterator& operator++() {
+                auto& promise = handle_.promise();
+                if (++promise.position >= promise.count)
+                    Resume(handle_);
+                return *this;
+            }
+
+            void operator++(int) { ++(*this); }
+
+            bool operator==(const iterator& other) const { return Done() == other.Done(); }
+            bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            inline bool Done() const { return !handle_ || handle_.done(); }
+
+            handle_type handle_;
+        };
+
+        generator(generator&& other) noexcept : handle_(other.handle_), started_(other.started_) {
+            other.handle_ = nullptr;
+        }
+
+        generator& operator=(generator&& other) noexcept {
+            if (this != &other) {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = other.handle_;
+                started_ = other.started_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+
+        ~generator() {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        // Первый вызов запускает сопрограмму до первого значения, последующие возвращают текущую позицию.
+        iterator begin() {
+            if (!started_) {
+                started_ = true;
+                Resume(handle_);
+            }
+            return iterator(handle_);
+        }
+
+        iterator end() { return iterator(); }
+
+    private:
+        explicit generator(handle_type handle) : handle_(handle) {}
+
+        // Возобновляет сопрограмму до следующего непустого значения или завершения.
+        // Исключение, выброшенное в сопрограмме, передается вызывающей стороне.
+        static void Resume(handle_type handle) {
+            do {
+                handle.resume();
+            } while (!handle.done() && handle.promise().count == 0);
+            if (handle.done() && handle.promise().exception)
+                std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+        }
+
+        handle_type handle_;
+        bool started_ = false;
+    };
+}
+
+#endif
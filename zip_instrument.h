@@ -0,0 +1,208 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define ZIPCPP_HAS_USDT 1
+#endif
+#endif
+
+/* Счетчики операций итераторов Zip, включаемые определением макроса ZIPCPP_INSTRUMENT до подключения zip.h.
+ * Макрос должен быть одинаково определен во всех единицах трансляции программы.
+ * Без ZIPCPP_INSTRUMENT этот файл не подключается, а точки подсчета в zip.h раскрываются в пустые выражения.
+ */
+
+namespace zipcpp::instrument {
+    struct counters {
+        uint64_t advances = 0;           // ++, --, +=, -= над ZipIterator
+        uint64_t iterator_advances = 0;  // те же операции над хранимыми итераторами
+        uint64_t dereferences = 0;
+        uint64_t comparisons = 0;        // ==, !=, <, >, <=, >=
+
+        counters& operator+=(const counters& other) {
+            advances += other.advances;
+            iterator_advances += other.iterator_advances;
+            dereferences += other.dereferences;
+            comparisons += other.comparisons;
+            return *this;
+        }
+    };
+
+    struct site_report {
+        const char* name;
+        const char* file;
+        int line;
+        uint64_t loops;
+        counters totals;
+    };
+
+    // Место в программе, помеченное макросом ZIPCPP_LOOP. Итоговые значения счетчиков накапливаются атомарно
+    //  при выходе из каждой области, а внутри области счетчики текущего потока не разделяются с другими потоками.
+    class site {
+    public:
+        site(const char* name, const char* file, int line);
+
+        void Flush(const counters& local) {
+            loops_.fetch_add(1, std::memory_order_relaxed);
+            advances_.fetch_add(local.advances, std::memory_order_relaxed);
+            iterator_advances_.fetch_add(local.iterator_advances, std::memory_order_relaxed);
+            dereferences_.fetch_add(local.dereferences, std::memory_order_relaxed);
+            comparisons_.fetch_add(local.comparisons, std::memory_order_relaxed);
+        }
+
+        site_report Report() const {
+            counters totals;
+            totals.advances = advances_.load(std::memory_order_relaxed);
+            totals.iterator_advances = iterator_advances_.load(std::memory_order_relaxed);
+            totals.dereferences = dereferences_.load(std::memory_order_relaxed);
+            totals.comparisons = comparisons_.load(std::memory_order_relaxed);
+            return {name_, file_, line_, loops_.load(std::memory_order_relaxed), totals};
+        }
+
+        void Reset() {
+            for (auto* value : {&loops_, &advances_, &iterator_advances_, &dereferences_, &comparisons_})
+                value->store(0, std::memory_order_relaxed);
+        }
+
+        inline const char* name() const { return name_; }
+
+    private:
+        const char* name_;
+        const char* file_;
+        int line_;
+        std::atomic<uint64_t> loops_{0};
+        std::atomic<uint64_t> advances_{0};
+        std::atomic<uint64_t> iterator_advances_{0};
+        std::atomic<uint64_t> dereferences_{0};
+        std::atomic<uint64_t> comparisons_{0};
+    };
+}
+
+namespace zip_impl::instrument {
+    struct Registry {
+        std::mutex mutex;
+        std::vector<zipcpp::instrument::site*> sites;
+    };
+
+    inline Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    // Операции вне помеченных областей относятся к этому месту.
+    inline zipcpp::instrument::site& UnscopedSite() {
+        static zipcpp::instrument::site unscoped("<unscoped>", "", 0);
+        return unscoped;
+    }
+
+    struct ThreadState {
+        zipcpp::instrument::counters unscoped;
+        zipcpp::instrument::counters* current = &unscoped;
+
+        void FlushUnscoped() {
+            UnscopedSite().Flush(unscoped);
+            unscoped = {};
+        }
+
+        ~ThreadState() { FlushUnscoped(); }
+    };
+
+    inline ThreadState& GetThreadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    inline zipcpp::instrument::counters& Current() {
+        return *GetThreadState().current;
+    }
+
+    // Функции, на которые можно установить uprobe (perf probe -x <binary> zipcpp_loop_begin), если USDT недоступны.
+    // Пустая ассемблерная вставка не позволяет компилятору встроить или удалить вызов.
+#if defined(__GNUC__) || defined(__clang__)
+    extern "C" {
+    __attribute__((noinline, used)) inline void zipcpp_loop_begin(const char* name) {
+        asm volatile("" : : "r"(name) : "memory");
+    }
+    __attribute__((noinline, used)) inline void zipcpp_loop_end(const char* name, const zipcpp::instrument::counters* totals) {
+        asm volatile("" : : "r"(name), "r"(totals) : "memory");
+    }
+    }
+#else
+    inline void zipcpp_loop_begin(const char*) {}
+    inline void zipcpp_loop_end(const char*, const zipcpp::instrument::counters*) {}
+#endif
+}
+
+namespace zipcpp::instrument {
+    inline site::site(const char* name, const char* file, int line) : name_(name), file_(file), line_(line) {
+        auto& registry = zip_impl::instrument::GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.sites.push_back(this);
+    }
+
+    // Область действия метки ZIPCPP_LOOP: операции текущего потока учитываются в счетчиках своего места.
+    class loop_scope {
+    public:
+        explicit loop_scope(site& where) : site_(where), previous_(zip_impl::instrument::GetThreadState().current) {
+            zip_impl::instrument::GetThreadState().current = &local_;
+#if defined(ZIPCPP_HAS_USDT)
+            DTRACE_PROBE1(zipcpp, loop_begin, site_.name());
+#endif
+            zip_impl::instrument::zipcpp_loop_begin(site_.name());
+        }
+
+        ~loop_scope() {
+            zip_impl::instrument::GetThreadState().current = previous_;
+            site_.Flush(local_);
+#if defined(ZIPCPP_HAS_USDT)
+            DTRACE_PROBE5(zipcpp, loop_end, site_.name(), local_.advances, local_.iterator_advances, local_.dereferences, local_.comparisons);
+#endif
+            zip_impl::instrument::zipcpp_loop_end(site_.name(), &local_);
+        }
+
+        loop_scope(const loop_scope&) = delete;
+        loop_scope& operator=(const loop_scope&) = delete;
+
+    private:
+        site& site_;
+        counters* previous_;
+        counters local_;
+    };
+
+    // Итоговые значения счетчиков всех мест. Операции вне помеченных областей текущего потока учитываются сразу,
+    //  других потоков - после их завершения.
+    inline std::vector<site_report> report() {
+        zip_impl::instrument::GetThreadState().FlushUnscoped();
+        const auto& unscoped = zip_impl::instrument::UnscopedSite();
+        auto& registry = zip_impl::instrument::GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<site_report> result;
+        result.reserve(registry.sites.size());
+        result.push_back(unscoped.Report());
+        for (const auto* where : registry.sites) {
+            if (where != &unscoped)
+                result.push_back(where->Report());
+        }
+        return result;
+    }
+
+    inline void reset() {
+        zip_impl::instrument::GetThreadState().unscoped = {};
+        auto& registry = zip_impl::instrument::GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto* where : registry.sites)
+            where->Reset();
+    }
+}
+
+#define ZIPCPP_CONCAT_IMPL(a, b) a##b
+#define ZIPCPP_CONCAT(a, b) ZIPCPP_CONCAT_IMPL(a, b)
+// Помечает область до конца текущего блока: операции итераторов Zip в ней учитываются под именем name.
+#define ZIPCPP_LOOP(name) \
+    static ::zipcpp::instrument::site ZIPCPP_CONCAT(zipcpp_site_, __LINE__)(name, __FILE__, __LINE__); \
+    ::zipcpp::instrument::loop_scope ZIPCPP_CONCAT(zipcpp_scope_, __LINE__)(ZIPCPP_CONCAT(zipcpp_site_, __LINE__))
@@ -0,0 +1,341 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "zip.h"
+#include "zip_unzip.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ZIPCPP_HAS_SSE2 1
+#endif
+
+/* Преобразование массива записей (AoS) в столбцы (SoA) и обратно. Поля записи должны идти подряд без выравнивающих
+ *  промежутков и совпадать по типам со столбцами, например, struct { float x, y, z; } и три столбца float.
+ */
+
+namespace zip_impl {
+    template <typename Container, typename = void>
+    struct HasResizeMethod : public std::false_type {};
+
+    template <typename Container>
+    struct HasResizeMethod<Container, std::void_t<decltype(std::declval<Container&>().resize(size_t{}))>> : public std::true_type {};
+
+    // Все поля записи имеют один тип, который можно переставлять векторными инструкциями как набор байтов.
+    template <typename... Fields>
+    inline constexpr bool kUniformFields = sizeof...(Fields) >= 2 && sizeof...(Fields) <= 4
+            && std::conjunction_v<std::is_same<std::tuple_element_t<0, std::tuple<Fields...>>, Fields>...>;
+
+    template <typename... Fields>
+    inline constexpr bool kPackedRecordFields = std::conjunction_v<std::is_trivially_copyable<Fields>...>;
+
+    template <typename Record, typename... Fields>
+    inline constexpr bool kPackedRecord = std::is_trivially_copyable_v<Record> && kPackedRecordFields<Fields...>
+            && sizeof(Record) == (sizeof(Fields) + ... + 0);
+
+    // Смещение поля с номером Index в записи без выравнивающих промежутков.
+    template <size_t Index, typename... Fields>
+    constexpr size_t FieldOffset() {
+        constexpr size_t sizes[] = {sizeof(Fields)...};
+        size_t offset = 0;
+        for (size_t i = 0; i < Index; ++i)
+            offset += sizes[i];
+        return offset;
+    }
+
+#if defined(ZIPCPP_HAS_SSE2)
+    // [p0[A], p1[B], q0[C], q1[D]] для 32-битных элементов: две перестановки выбирают пары, третья объединяет их.
+    template <int A, int B, int C, int D>
+    inline __m128 Gather4(__m128 p0, __m128 p1, __m128 q0, __m128 q1) {
+        __m128 low = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(B, B, A, A));
+        __m128 high = _mm_shuffle_ps(q0, q1, _MM_SHUFFLE(D, D, C, C));
+        return _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    inline __m128 Load4(const unsigned char* p) { return _mm_loadu_ps(reinterpret_cast<const float*>(p)); }
+    inline void Store4(unsigned char* p, __m128 v) { _mm_storeu_ps(reinterpret_cast<float*>(p), v); }
+    inline __m128d Load8(const unsigned char* p) { return _mm_loadu_pd(reinterpret_cast<const double*>(p)); }
+    inline void Store8(unsigned char* p, __m128d v) { _mm_storeu_pd(reinterpret_cast<double*>(p), v); }
+
+    /* Векторные ядра SSE2 для полей по 4 и 8 байт. Значения переставляются как биты, поэтому ядра подходят для
+     *  float, double и целых чисел. Возвращают количество обработанных записей, остаток обрабатывается скалярным циклом.
+     */
+    template <size_t Size, size_t N>
+    size_t DeinterleaveSimd(const unsigned char* src, size_t count, unsigned char* const* dst) {
+        size_t i = 0;
+        if constexpr (Size == 4 && N == 2) {
+            for (; i + 4 <= count; i += 4, src += 32) {
+                __m128 a = Load4(src), b = Load4(src + 16);
+                Store4(dst[0] + 4 * i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                Store4(dst[1] + 4 * i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+        } else if constexpr (Size == 4 && N == 3) {
+            // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+            for (; i + 4 <= count; i += 4, src += 48) {
+                __m128 a = Load4(src), b = Load4(src + 16), c = Load4(src + 32);
+                Store4(dst[0] + 4 * i, Gather4<0, 3, 2, 1>(a, a, b, c));
+                Store4(dst[1] + 4 * i, Gather4<1, 0, 3, 2>(a, b, b, c));
+                Store4(dst[2] + 4 * i, Gather4<2, 1, 0, 3>(a, b, c, c));
+            }
+        } else if constexpr (Size == 4 && N == 4) {
+            for (; i + 4 <= count; i += 4, src += 64) {
+                __m128 a = Load4(src), b = Load4(src + 16), c = Load4(src + 32), d = Load4(src + 48);
+                _MM_TRANSPOSE4_PS(a, b, c, d);
+                Store4(dst[0] + 4 * i, a);
+                Store4(dst[1] + 4 * i, b);
+                Store4(dst[2] + 4 * i, c);
+                Store4(dst[3] + 4 * i, d);
+            }
+        } else if constexpr (Size == 8 && N == 2) {
+            for (; i + 2 <= count; i += 2, src += 32) {
+                __m128d a = Load8(src), b = Load8(src + 16);
+                Store8(dst[0] + 8 * i, _mm_unpacklo_pd(a, b));
+                Store8(dst[1] + 8 * i, _mm_unpackhi_pd(a, b));
+            }
+        } else if constexpr (Size == 8 && N == 3) {
+            // a = x0 y0, b = z0 x1, c = y1 z1
+            for (; i + 2 <= count; i += 2, src += 48) {
+                __m128d a = Load8(src), b = Load8(src + 16), c = Load8(src + 32);
+                Store8(dst[0] + 8 * i, _mm_shuffle_pd(a, b, 2));
+                Store8(dst[1] + 8 * i, _mm_shuffle_pd(a, c, 1));
+                Store8(dst[2] + 8 * i, _mm_shuffle_pd(b, c, 2));
+            }
+        } else if constexpr (Size == 8 && N == 4) {
+            for (; i + 2 <= count; i += 2, src += 64) {
+                __m128d a = Load8(src), b = Load8(src + 16), c = Load8(src + 32), d = Load8(src + 48);
+                Store8(dst[0] + 8 * i, _mm_unpacklo_pd(a, c));
+                Store8(dst[1] + 8 * i, _mm_unpackhi_pd(a, c));
+                Store8(dst[2] + 8 * i, _mm_unpacklo_pd(b, d));
+                Store8(dst[3] + 8 * i, _mm_unpackhi_pd(b, d));
+            }
+        }
+        return i;
+    }
+
+    template <size_t Size, size_t N>
+    size_t InterleaveSimd(const unsigned char* const* src, size_t count, unsigned char* dst) {
+        size_t i = 0;
+        if constexpr (Size == 4 && N == 2) {
+            for (; i + 4 <= count; i += 4, dst += 32) {
+                __m128 x = Load4(src[0] + 4 * i), y = Load4(src[1] + 4 * i);
+                Store4(dst, _mm_unpacklo_ps(x, y));
+                Store4(dst + 16, _mm_unpackhi_ps(x, y));
+            }
+        } else if constexpr (Size == 4 && N == 3) {
+            for (; i + 4 <= count; i += 4, dst += 48) {
+                __m128 x = Load4(src[0] + 4 * i), y = Load4(src[1] + 4 * i), z = Load4(src[2] + 4 * i);
+                Store4(dst, Gather4<0, 0, 0, 1>(x, y, z, x));
+                Store4(dst + 16, Gather4<1, 1, 2, 2>(y, z, x, y));
+                Store4(dst + 32, Gather4<2, 3, 3, 3>(z, x, y, z));
+            }
+        } else if constexpr (Size == 4 && N == 4) {
+            for (; i + 4 <= count; i += 4, dst += 64) {
+                __m128 x = Load4(src[0] + 4 * i), y = Load4(src[1] + 4 * i), z = Load4(src[2] + 4 * i), w = Load4(src[3] + 4 * i);
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+                Store4(dst, x);
+                Store4(dst + 16, y);
+                Store4(dst + 32, z);
+                Store4(dst + 48, w);
+            }
+        } else if constexpr (Size == 8 && N == 2) {
+            for (; i + 2 <= count; i += 2, dst += 32) {
+                __m128d x = Load8(src[0] + 8 * i), y = Load8(src[1] + 8 * i);
+                Store8(dst, _mm_unpacklo_pd(x, y));
+                Store8(dst + 16, _mm_unpackhi_pd(x, y));
+            }
+        } else if constexpr (Size == 8 && N == 3) {
+            for (; i + 2 <= count; i += 2, dst += 48) {
+                __m128d x = Load8(src[0] + 8 * i), y = Load8(src[1] + 8 * i), z = Load8(src[2] + 8 * i);
+                Store8(dst, _mm_shuffle_pd(x, y, 0));
+                Store8(dst + 16, _mm_shuffle_pd(z, x, 2));
+                Store8(dst + 32, _mm_shuffle_pd(y, z, 3));
+            }
+        } else if constexpr (Size == 8 && N == 4) {
+            for (; i + 2 <= count; i += 2, dst += 64) {
+                __m128d x = Load8(src[0] + 8 * i), y = Load8(src[1] + 8 * i), z = Load8(src[2] + 8 * i), w = Load8(src[3] + 8 * i);
+                Store8(dst, _mm_unpacklo_pd(x, y));
+                Store8(dst + 16, _mm_unpacklo_pd(z, w));
+                Store8(dst + 32, _mm_unpackhi_pd(x, y));
+                Store8(dst + 48, _mm_unpackhi_pd(z, w));
+            }
+        }
+        return i;
+    }
+#endif
+
+    /* Записи с N полями типа T и N столбцов в непрерывной памяти. Для полей по 4 и 8 байт используются ядра SSE2,
+     *  для остальных типов и для остатка - скалярный цикл по указателям, который компилятор может векторизовать сам.
+     */
+    template <typename T, size_t N>
+    void DeinterleaveUniform(const unsigned char* src, size_t count, T* const* dst) {
+        size_t i = 0;
+#if defined(ZIPCPP_HAS_SSE2)
+        if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+            unsigned char* bytes[N];
+            for (size_t k = 0; k < N; ++k)
+                bytes[k] = reinterpret_cast<unsigned char*>(dst[k]);
+            i = DeinterleaveSimd<sizeof(T), N>(src, count, bytes);
+        }
+#endif
+        const unsigned char* end = src + count * N * sizeof(T);
+        for (const unsigned char* record = src + i * N * sizeof(T); record != end; record += N * sizeof(T), ++i)
+            for (size_t k = 0; k < N; ++k)
+                std::memcpy(&dst[k][i], record + k * sizeof(T), sizeof(T));
+    }
+
+    template <typename T, size_t N>
+    void InterleaveUniform(const T* const* src, size_t count, unsigned char* dst) {
+        size_t i = 0;
+#if defined(ZIPCPP_HAS_SSE2)
+        if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+            const unsigned char* bytes[N];
+            for (size_t k = 0; k < N; ++k)
+                bytes[k] = reinterpret_cast<const unsigned char*>(src[k]);
+            i = InterleaveSimd<sizeof(T), N>(bytes, count, dst);
+        }
+#endif
+        unsigned char* end = dst + count * N * sizeof(T);
+        for (unsigned char* record = dst + i * N * sizeof(T); record != end; record += N * sizeof(T), ++i)
+            for (size_t k = 0; k < N; ++k)
+                std::memcpy(record + k * sizeof(T), &src[k][i], sizeof(T));
+    }
+
+    // Обход строк объекта Zip с копированием полей записи по смещениям: для столбцов без непрерывной памяти и разнотипных полей.
+    template <typename... Fields, typename Row, size_t... Indexes>
+    inline void ReadRecord(const unsigned char* record, Row&& row, std::index_sequence<Indexes...>) {
+        (std::memcpy(std::addressof(RowElement<Indexes>(row)), record + FieldOffset<Indexes, Fields...>(), sizeof(Fields)), ...);
+    }
+
+    template <typename... Fields, typename Row, size_t... Indexes>
+    inline void WriteRecord(unsigned char* record, Row&& row, std::index_sequence<Indexes...>) {
+        ((void)std::memcpy(record + FieldOffset<Indexes, Fields...>(), std::addressof(RowElement<Indexes>(row)), sizeof(Fields)), ...);
+    }
+
+    template <typename Container>
+    auto AppendedRange(Container& container, size_t count) {
+        size_t old_size = container.size();
+        container.resize(old_size + count);
+        return zipcpp::IterRange(std::next(std::begin(container), static_cast<std::ptrdiff_t>(old_size)), std::end(container));
+    }
+
+    template <typename Iterator, typename T>
+    inline constexpr bool kContiguousOf = IsContiguousIterator<Iterator>::value
+            && std::is_same_v<typename std::iterator_traits<Iterator>::value_type, T>;
+
+    template <typename Iterator>
+    struct ZipColumns {
+        static constexpr bool contiguous = false;
+    };
+
+    // Столбцы объекта Zip, которые можно читать через указатели на элементы одного типа.
+    template <typename... Iters>
+    struct ZipColumns<ZipIterator<Iters...>> {
+        using first_value = typename std::iterator_traits<std::tuple_element_t<0, std::tuple<Iters...>>>::value_type;
+        static constexpr bool contiguous = sizeof...(Iters) >= 2 && sizeof...(Iters) <= 4
+                && std::conjunction_v<std::bool_constant<kContiguousOf<Iters, first_value>>...>;
+    };
+
+    template <typename... Iters>
+    struct ZipColumns<ConstZipIterator<Iters...>> : public ZipColumns<ZipIterator<Iters...>> {};
+
+    template <typename Iterator, size_t... Indexes>
+    auto ColumnPointers(const Iterator& first, std::index_sequence<Indexes...>) {
+        using T = typename ZipColumns<Iterator>::first_value;
+        return std::array<const T*, sizeof...(Indexes)>{std::addressof(*std::get<Indexes>(first.AsTuple()))...};
+    }
+
+    template <typename Row, size_t... Indexes>
+    auto RowFieldTypes(std::index_sequence<Indexes...>)
+            -> std::tuple<std::decay_t<decltype(RowElement<Indexes>(std::declval<Row>()))>...>;
+
+    template <typename Record, typename... Fields>
+    struct InterleaveRecord {
+        static_assert(kPackedRecord<Record, Fields...>,
+                      "interleave requires trivially copyable records whose fields match the row elements without padding");
+
+        template <typename Range>
+        static size_t Write(Range& rows, unsigned char* dst, size_t count) {
+            auto first = std::begin(rows);
+            constexpr size_t kFields = sizeof...(Fields);
+            if constexpr (ZipColumns<decltype(first)>::contiguous && kUniformFields<Fields...>) {
+                if (count != 0)
+                    InterleaveUniform<typename ZipColumns<decltype(first)>::first_value, kFields>(
+                            ColumnPointers(first, std::make_index_sequence<kFields>{}).data(), count, dst);
+            } else {
+                for (size_t i = 0; i < count; ++i, ++first, dst += sizeof(Record))
+                    WriteRecord<Fields...>(dst, *first, std::make_index_sequence<kFields>{});
+            }
+            return count;
+        }
+    };
+
+    template <typename Record, typename FieldTuple>
+    struct InterleaveRecordOf;
+
+    template <typename Record, typename... Fields>
+    struct InterleaveRecordOf<Record, std::tuple<Fields...>> {
+        using type = InterleaveRecord<Record, Fields...>;
+    };
+}
+
+
+namespace zipcpp {
+    /* Раскладывает массив записей в столбцы: k-е поле каждой записи добавляется в конец k-го контейнера.
+     * records - контейнер записей в непрерывной памяти (std::vector, массив, std::span), контейнеры - с методом resize.
+     * Если все поля одного типа размером 4 или 8 байт (2-4 поля), а контейнеры - std::vector, то записи переставляются
+     *  векторными инструкциями SSE2; для полей другого размера используется цикл по указателям, а для остальных
+     *  контейнеров и разнотипных полей - обход zip(containers...) с копированием полей по смещениям.
+     * Возвращает количество записей.
+     */
+    template <typename Records, typename... Containers>
+    size_t deinterleave(const Records& records, Containers&... containers) {
+        using Record = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(records))>>;
+        static_assert(zip_impl::kPackedRecord<Record, typename Containers::value_type...>,
+                      "deinterleave requires trivially copyable records whose fields match the containers without padding");
+        static_assert(std::conjunction_v<zip_impl::HasResizeMethod<Containers>...>, "deinterleave requires containers with resize()");
+        size_t count = std::size(records);
+        const auto* src = reinterpret_cast<const unsigned char*>(std::data(records));
+        constexpr size_t kFields = sizeof...(Containers);
+        if constexpr (zip_impl::kUniformFields<typename Containers::value_type...>
+                      && std::conjunction_v<zip_impl::IsPointerWritable<Containers>...>) {
+            using T = typename std::tuple_element_t<0, std::tuple<Containers...>>::value_type;
+            T* dst[kFields] = {zip_impl::AppendedData(containers, count)...};
+            zip_impl::DeinterleaveUniform<T, kFields>(src, count, dst);
+        } else {
+            auto rows = zip(zip_impl::AppendedRange(containers, count)...);
+            for (auto&& row : rows) {
+                zip_impl::ReadRecord<typename Containers::value_type...>(src, row, std::make_index_sequence<kFields>{});
+                src += sizeof(Record);
+            }
+        }
+        return count;
+    }
+
+    /* Собирает строки в массив записей: k-й элемент строки записывается в k-е поле записи.
+     * Контейнер записей с методом resize (std::vector) увеличивается на количество строк; в контейнер без него
+     *  (массив, std::span) записывается не больше строк, чем в нем помещается. Строки объекта Zip по столбцам
+     *  в непрерывной памяти одного типа размером 4 или 8 байт переставляются векторными инструкциями SSE2.
+     * Возвращает количество записанных записей.
+     */
+    template <typename Range, typename Records>
+    size_t interleave(Range&& rows, Records& records) {
+        using Record = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(records))>>;
+        using Row = decltype(*std::begin(rows));
+        using Fields = decltype(zip_impl::RowFieldTypes<Row>(std::make_index_sequence<std::tuple_size_v<std::decay_t<Row>>>{}));
+        size_t count = zip_impl::RangeSize(rows);
+        unsigned char* dst;
+        if constexpr (zip_impl::HasResizeMethod<Records>::value) {
+            dst = reinterpret_cast<unsigned char*>(zip_impl::AppendedData(records, count));
+        } else {
+            count = std::min(count, static_cast<size_t>(std::size(records)));
+            dst = reinterpret_cast<unsigned char*>(std::data(records));
+        }
+        return zip_impl::InterleaveRecordOf<Record, Fields>::type::Write(rows, dst, count);
+    }
+}
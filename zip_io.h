@@ -0,0 +1,418 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "zip.h"
+#include "zip_unzip.h"
+
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* Запись столбцов объекта Zip в двоичный файл и чтение его через отображение в память (POSIX).
+ * Формат файла: заголовок (сигнатура, версия, количество столбцов и строк), описания столбцов (размер и тип элемента,
+ *  смещение данных от начала заголовка) и данные столбцов подряд, каждый с границы 64 байт, поэтому столбцы
+ *  прочитанного файла можно использовать напрямую через указатели на отображенную память.
+ */
+
+namespace zip_impl {
+    inline constexpr char kColumnFileMagic[8] = {'Z', 'I', 'P', 'C', 'O', 'L', 'S', '1'};
+    inline constexpr uint32_t kColumnFileVersion = 1;
+    inline constexpr size_t kColumnAlignment = 64;
+    // Общий размер промежуточных буферов при записи столбцов без непрерывной памяти.
+    inline constexpr size_t kStagingBytes = 1 << 20;
+
+    struct ColumnFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t columns;
+        uint64_t rows;
+    };
+
+    struct ColumnDescriptor {
+        uint32_t element_size;
+        uint32_t type;
+        uint64_t offset;
+    };
+
+    // Вид значений столбца; размер значения хранится отдельно.
+    enum ColumnType : uint32_t {
+        kRawColumn = 0,
+        kSignedColumn = 1,
+        kUnsignedColumn = 2,
+        kFloatColumn = 3,
+        kBoolColumn = 4,
+    };
+
+    template <typename T>
+    constexpr uint32_t ColumnTypeOf() {
+        if constexpr (std::is_same_v<T, bool>)
+            return kBoolColumn;
+        else if constexpr (std::is_floating_point_v<T>)
+            return kFloatColumn;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            return kSignedColumn;
+        else if constexpr (std::is_integral_v<T>)
+            return kUnsignedColumn;
+        else
+            return kRawColumn;
+    }
+
+    inline constexpr size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    [[noreturn]] inline void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    // Записывает все блоки iov, повторяя writev после частичной записи и прерывания сигналом.
+    inline void WriteAll(int fd, std::vector<iovec>& iov) {
+        size_t first = 0;
+        while (first < iov.size()) {
+            int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+            ssize_t written = ::writev(fd, iov.data() + first, count);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                ThrowSystemError("writev");
+            }
+            size_t left = static_cast<size_t>(written);
+            while (first < iov.size() && left >= iov[first].iov_len)
+                left -= iov[first++].iov_len;
+            if (left != 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+    }
+
+    inline void PwriteAll(int fd, const void* data, size_t size, off_t offset) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size != 0) {
+            ssize_t written = ::pwrite(fd, bytes, size, offset);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                ThrowSystemError("pwrite");
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+            offset += written;
+        }
+    }
+
+    inline void PreadAll(int fd, void* data, size_t size, off_t offset) {
+        char* bytes = static_cast<char*>(data);
+        while (size != 0) {
+            ssize_t read = ::pread(fd, bytes, size, offset);
+            if (read < 0) {
+                if (errno == EINTR)
+                    continue;
+                ThrowSystemError("pread");
+            }
+            if (read == 0)
+                throw std::runtime_error("pread: unexpected end of file");
+            bytes += read;
+            size -= static_cast<size_t>(read);
+            offset += read;
+        }
+    }
+
+    class FileDescriptor {
+    public:
+        FileDescriptor(const std::string& path, int flags, mode_t mode = 0) : fd_(::open(path.c_str(), flags, mode)) {
+            if (fd_ < 0)
+                ThrowSystemError("open");
+        }
+
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+        ~FileDescriptor() { ::close(fd_); }
+
+        inline int get() const { return fd_; }
+
+    private:
+        int fd_;
+    };
+
+    // Файл, отображенный в память только для чтения; отображение снимается деструктором, в том числе при исключении.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        MappedFile(int fd, size_t size) : size_(size) {
+            void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+                ThrowSystemError("mmap");
+            data_ = static_cast<const unsigned char*>(data);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        ~MappedFile() {
+            if (data_ != nullptr)
+                ::munmap(const_cast<unsigned char*>(data_), size_);
+        }
+
+        inline const unsigned char* data() const { return data_; }
+        inline size_t size() const { return size_; }
+
+    private:
+        const unsigned char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Заголовок и описания столбцов, дополненные нулями до начала данных первого столбца.
+    template <typename... Values>
+    std::vector<unsigned char> ColumnFileLayout(size_t rows, std::vector<ColumnDescriptor>& descriptors) {
+        constexpr size_t kColumns = sizeof...(Values);
+        size_t offset = AlignUp(sizeof(ColumnFileHeader) + kColumns * sizeof(ColumnDescriptor), kColumnAlignment);
+        descriptors = {ColumnDescriptor{static_cast<uint32_t>(sizeof(Values)), ColumnTypeOf<Values>(), 0}...};
+        for (auto& descriptor : descriptors) {
+            descriptor.offset = offset;
+            offset = AlignUp(offset + rows * descriptor.element_size, kColumnAlignment);
+        }
+
+        ColumnFileHeader header{};
+        std::memcpy(header.magic, kColumnFileMagic, sizeof(header.magic));
+        header.version = kColumnFileVersion;
+        header.columns = static_cast<uint32_t>(kColumns);
+        header.rows = rows;
+
+        std::vector<unsigned char> bytes(kColumns != 0 ? descriptors[0].offset : sizeof(ColumnFileHeader), 0);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        if (kColumns != 0)
+            std::memcpy(bytes.data() + sizeof(header), descriptors.data(), kColumns * sizeof(ColumnDescriptor));
+        return bytes;
+    }
+
+    template <typename Iterator>
+    using IteratorValue = typename std::iterator_traits<Iterator>::value_type;
+
+    template <typename Row, size_t... Indexes>
+    auto RowValueTypes(std::index_sequence<Indexes...>)
+            -> std::tuple<std::decay_t<decltype(RowElement<Indexes>(std::declval<Row>()))>...>;
+
+    // Строки другого диапазона (например, представления take) записываются через промежуточные буферы.
+    template <typename Iterator>
+    struct ZipColumnValues {
+        using row = typename std::iterator_traits<Iterator>::value_type;
+        static constexpr bool contiguous = false;
+        using values = decltype(RowValueTypes<row>(std::make_index_sequence<std::tuple_size_v<std::decay_t<row>>>{}));
+    };
+
+    template <typename... Iters>
+    struct ZipColumnValues<ZipIterator<Iters...>> {
+        static constexpr bool contiguous = std::conjunction_v<IsContiguousIterator<Iters>...>;
+        using values = std::tuple<IteratorValue<Iters>...>;
+    };
+
+    template <typename... Iters>
+    struct ZipColumnValues<ConstZipIterator<Iters...>> : public ZipColumnValues<ZipIterator<Iters...>> {};
+
+    // Столбцы в непрерывной памяти записываются одним вызовом writev без копирования элементов.
+    template <typename... Values, typename Iterator, size_t... Indexes>
+    size_t WriteContiguousColumns(int fd, const Iterator& first, size_t rows, std::index_sequence<Indexes...>) {
+        static const unsigned char zeros[kColumnAlignment] = {};
+        std::vector<ColumnDescriptor> descriptors;
+        std::vector<unsigned char> header = ColumnFileLayout<Values...>(rows, descriptors);
+
+        std::vector<iovec> iov;
+        iov.push_back({header.data(), header.size()});
+        const void* data[] = {(rows != 0 ? static_cast<const void*>(std::addressof(*std::get<Indexes>(first.AsTuple()))) : nullptr)...};
+        size_t end = header.size();
+        for (size_t k = 0; k < descriptors.size(); ++k) {
+            size_t bytes = rows * descriptors[k].element_size;
+            if (bytes != 0)
+                iov.push_back({const_cast<void*>(data[k]), bytes});
+            end = descriptors[k].offset + bytes;
+            size_t padding = k + 1 < descriptors.size() ? descriptors[k + 1].offset - end : 0;
+            if (padding != 0)
+                iov.push_back({const_cast<unsigned char*>(zeros), padding});
+        }
+        WriteAll(fd, iov);
+        return end;
+    }
+
+    /* Столбцы без непрерывной памяти копируются за один обход строк в промежуточные буферы, по одному на столбец,
+     *  и заполненный буфер записывается pwrite по текущему смещению своего столбца. Требуется файл с позиционированием.
+     */
+    template <typename... Values, typename Range, size_t... Indexes>
+    size_t WriteStagedColumns(int fd, Range& range, size_t rows, std::index_sequence<Indexes...>) {
+        constexpr size_t kColumns = sizeof...(Values);
+        off_t base = ::lseek(fd, 0, SEEK_CUR);
+        if (base < 0)
+            ThrowSystemError("lseek");
+        std::vector<ColumnDescriptor> descriptors;
+        std::vector<unsigned char> header = ColumnFileLayout<Values...>(rows, descriptors);
+        PwriteAll(fd, header.data(), header.size(), base);
+
+        constexpr size_t sizes[] = {sizeof(Values)...};
+        size_t staged_rows = std::max<size_t>(1, kStagingBytes / (sizeof(Values) + ...));
+        std::vector<unsigned char> buffers[kColumns];
+        for (size_t k = 0; k < kColumns; ++k)
+            buffers[k].resize(staged_rows * sizes[k]);
+        off_t offsets[] = {static_cast<off_t>(base + static_cast<off_t>(descriptors[Indexes].offset))...};
+
+        auto flush = [&](size_t count) {
+            for (size_t k = 0; k < kColumns; ++k) {
+                PwriteAll(fd, buffers[k].data(), count * sizes[k], offsets[k]);
+                offsets[k] += static_cast<off_t>(count * sizes[k]);
+            }
+        };
+        size_t staged = 0;
+        size_t written = 0;
+        for (auto it = std::begin(range); written + staged < rows; ++it) {
+            auto&& row = *it;
+            ((void)[&] {
+                Values value = RowElement<Indexes>(row);
+                std::memcpy(buffers[Indexes].data() + staged * sizeof(Values), &value, sizeof(Values));
+            }(), ...);
+            if (++staged == staged_rows) {
+                flush(staged);
+                written += staged;
+                staged = 0;
+            }
+        }
+        flush(staged);
+
+        size_t end = kColumns != 0 ? descriptors.back().offset + rows * descriptors.back().element_size : header.size();
+        if (::lseek(fd, base + static_cast<off_t>(end), SEEK_SET) < 0)
+            ThrowSystemError("lseek");
+        return end;
+    }
+
+    template <typename Range, typename... Values, size_t... Indexes>
+    size_t WriteColumns(int fd, Range& range, std::tuple<Values...>*, std::index_sequence<Indexes...> indexes) {
+        static_assert(std::conjunction_v<std::is_trivially_copyable<Values>...>,
+                      "write_columns requires trivially copyable column values");
+        auto first = std::begin(range);
+        size_t rows = range.size();
+        if constexpr (ZipColumnValues<decltype(first)>::contiguous)
+            return WriteContiguousColumns<Values...>(fd, first, rows, indexes);
+        else
+            return WriteStagedColumns<Values...>(fd, range, rows, indexes);
+    }
+}
+
+
+namespace zipcpp {
+    /* Записывает столбцы объекта Zip в файловый дескриптор в формате, описанном в начале файла zip_io.h,
+     *  начиная с текущей позиции; смещения столбцов отсчитываются от начала заголовка. Вместо объекта Zip можно передать
+     *  другой диапазон строк-кортежей с методом size, например, представление take.
+     * Столбцы в непрерывной памяти записываются одним вызовом writev прямо из контейнеров (подходит и для каналов),
+     *  остальные - через промежуточные буферы вызовами pwrite (нужен файл с позиционированием).
+     * Значения столбцов должны быть тривиально копируемыми. Возвращает количество записанных байтов.
+     * При ошибке ввода-вывода выбрасывается std::system_error.
+     */
+    template <typename ZipType>
+    size_t write_columns(int fd, ZipType&& rows) {
+        using Iterator = decltype(std::begin(rows));
+        using Values = typename zip_impl::ZipColumnValues<Iterator>::values;
+        return zip_impl::WriteColumns(fd, rows, static_cast<Values*>(nullptr),
+                                      std::make_index_sequence<std::tuple_size_v<Values>>{});
+    }
+
+    // То же для файла path, который создается или перезаписывается.
+    template <typename ZipType>
+    size_t write_columns(const std::string& path, ZipType&& rows) {
+        zip_impl::FileDescriptor file(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return write_columns(file.get(), std::forward<ZipType>(rows));
+    }
+
+    /* Файл, записанный write_columns, отображенный в память только для чтения. Столбцы возвращаются как диапазоны
+     *  указателей на отображенную память без копирования, например:
+     *   zipcpp::column_file file("prices.bin");
+     *   for (const auto& [id, price] : file.as_zip<int, double>()) ...
+     * Диапазоны действительны, пока существует объект column_file.
+     */
+    class column_file {
+    public:
+        explicit column_file(const std::string& path) {
+            zip_impl::FileDescriptor file(path, O_RDONLY);
+            struct stat status {};
+            if (::fstat(file.get(), &status) != 0)
+                zip_impl::ThrowSystemError("fstat");
+            size_t size = static_cast<size_t>(status.st_size);
+            if (size < sizeof(zip_impl::ColumnFileHeader))
+                throw std::runtime_error("column_file: file is too short");
+            mapping_ = zip_impl::MappedFile(file.get(), size);
+            const unsigned char* data = mapping_.data();
+
+            std::memcpy(&header_, data, sizeof(header_));
+            if (std::memcmp(header_.magic, zip_impl::kColumnFileMagic, sizeof(header_.magic)) != 0
+                    || header_.version != zip_impl::kColumnFileVersion)
+                throw std::runtime_error("column_file: not a column file");
+            // Размеры из заголовка проверяются делением, чтобы поврежденный файл не вызывал переполнения
+            //  и выделения памяти по количеству столбцов, которых в файле нет.
+            if (header_.columns > (size - sizeof(header_)) / sizeof(zip_impl::ColumnDescriptor))
+                throw std::runtime_error("column_file: truncated file");
+            descriptors_.resize(header_.columns);
+            if (!descriptors_.empty())
+                std::memcpy(descriptors_.data(), data + sizeof(header_), descriptors_.size() * sizeof(zip_impl::ColumnDescriptor));
+            for (const auto& descriptor : descriptors_) {
+                // write_columns выравнивает начало каждого столбца по kColumnAlignment, что достаточно для любого типа значений.
+                if (descriptor.element_size == 0 || descriptor.offset % zip_impl::kColumnAlignment != 0)
+                    throw std::runtime_error("column_file: corrupt column descriptor");
+                if (descriptor.offset > size || header_.rows > (size - descriptor.offset) / descriptor.element_size)
+                    throw std::runtime_error("column_file: truncated file");
+            }
+        }
+
+        column_file(const column_file&) = delete;
+        column_file& operator=(const column_file&) = delete;
+
+        inline size_t size() const { return static_cast<size_t>(header_.rows); }
+        inline size_t columns() const { return descriptors_.size(); }
+
+        // Столбец с номером index как диапазон значений типа T. Если размер или вид значений не совпадает
+        //  с записанными, выбрасывается std::invalid_argument.
+        template <typename T>
+        IterRange<const T*> column(size_t index) const {
+            if (index >= descriptors_.size())
+                throw std::out_of_range("column_file: column index out of range");
+            const auto& descriptor = descriptors_[index];
+            if (descriptor.element_size != sizeof(T) || descriptor.type != zip_impl::ColumnTypeOf<T>())
+                throw std::invalid_argument("column_file: column type mismatch");
+            const T* first = reinterpret_cast<const T*>(mapping_.data() + descriptor.offset);
+            return IterRange<const T*>(first, first + size());
+        }
+
+        // Объект Zip по первым sizeof...(Types) столбцам.
+        template <typename... Types>
+        auto as_zip() const {
+            return AsZip<Types...>(std::index_sequence_for<Types...>{});
+        }
+
+    private:
+        template <typename... Types, size_t... Indexes>
+        auto AsZip(std::index_sequence<Indexes...>) const {
+            return zip(column<Types>(Indexes)...);
+        }
+
+        zip_impl::MappedFile mapping_;
+        zip_impl::ColumnFileHeader header_{};
+        std::vector<zip_impl::ColumnDescriptor> descriptors_;
+    };
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "zip.h"
+
+namespace zip_impl {
+
+    template <typename Key, typename T>
+    inline size_t KeyHash(const T& value) {
+        return MixHash(std::hash<Key>{}(value));
+    }
+
+    // Хеш-таблица с открытой адресацией и линейным пробированием, хранящая номера строк.
+    // Строки с одинаковым хешем образуют цепочку в массиве next_, поэтому ячейка таблицы занимается один раз на хеш.
+    class FlatRowTable {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        explicit FlatRowTable(size_t rows) {
+            size_t capacity = 16;
+            while (capacity < 2 * rows)
+                capacity *= 2;
+            slots_.assign(capacity, Slot{0, npos});
+            mask_ = capacity - 1;
+            rows_.reserve(rows);
+            next_.reserve(rows);
+        }
+
+        void Insert(size_t hash, size_t row) {
+            size_t pos = hash & mask_;
+            while (slots_[pos].head != npos && slots_[pos].hash != hash)
+                pos = (pos + 1) & mask_;
+            rows_.push_back(row);
+            next_.push_back(slots_[pos].head);
+            slots_[pos] = Slot{hash, rows_.size() - 1};
+        }
+
+        inline const void* SlotAddress(size_t hash) const {
+            return &slots_[hash & mask_];
+        }
+
+        // Вызывает f для каждой строки с заданным хешем. Равенство ключей проверяет вызывающая сторона.
+        template <typename F>
+        void ForEachCandidate(size_t hash, F&& f) const {
+            for (size_t pos = hash & mask_; slots_[pos].head != npos; pos = (pos + 1) & mask_) {
+                if (slots_[pos].hash == hash) {
+                    for (size_t entry = slots_[pos].head; entry != npos; entry = next_[entry])
+                        f(rows_[entry]);
+                    return;
+                }
+            }
+        }
+
+    private:
+        struct Slot {
+            size_t hash;
+            size_t head;
+        };
+
+        std::vector<Slot> slots_;
+        std::vector<size_t> rows_;
+        std::vector<size_t> next_;
+        size_t mask_ = 0;
+    };
+
+    // Последовательность номеров строк 0, 1, ..., n-1, не требующая выделения памяти.
+    struct RowSequence {
+        size_t count;
+        inline size_t size() const { return count; }
+        inline size_t operator[](size_t index) const { return index; }
+    };
+
+    // Количество строк, для которых хеши вычисляются и соответствующие ячейки таблицы загружаются в кэш заранее.
+    constexpr size_t kProbeBatch = 16;
+
+    template <size_t BuildKey, size_t ProbeKey, typename Key,
+              typename BuildIt, typename BuildRows, typename ProbeIt, typename ProbeRows, typename Emit>
+    void BuildAndProbe(BuildIt build, const BuildRows& build_rows, ProbeIt probe, const ProbeRows& probe_rows, Emit& emit) {
+        FlatRowTable table(build_rows.size());
+        // Вставка в обратном порядке сохраняет исходный порядок строк внутри цепочек.
+        for (size_t i = build_rows.size(); i-- > 0;) {
+            size_t row = build_rows[i];
+            table.Insert(KeyHash<Key>(get<BuildKey>(build[row])), row);
+        }
+
+        size_t hashes[kProbeBatch];
+        for (size_t start = 0; start < probe_rows.size(); start += kProbeBatch) {
+            size_t count = std::min(kProbeBatch, probe_rows.size() - start);
+            for (size_t i = 0; i < count; ++i) {
+                hashes[i] = KeyHash<Key>(get<ProbeKey>(probe[probe_rows[start + i]]));
+                Prefetch(table.SlotAddress(hashes[i]));
+            }
+            for (size_t i = 0; i < count; ++i) {
+                auto probe_row = probe[probe_rows[start + i]];
+                table.ForEachCandidate(hashes[i], [&](size_t row) {
+                    auto build_row = build[row];
+                    if (get<BuildKey>(build_row) == get<ProbeKey>(probe_row))
+                        emit(build_row, probe_row);
+                });
+            }
+        }
+    }
+
+    template <size_t BuildKey, size_t ProbeKey, typename Key, typename BuildIt, typename ProbeIt, typename Emit>
+    void HashJoin(BuildIt build, size_t build_size, ProbeIt probe, size_t probe_size, Emit& emit, size_t threads) {
+        if (threads <= 1) {
+            BuildAndProbe<BuildKey, ProbeKey, Key>(build, RowSequence{build_size}, probe, RowSequence{probe_size}, emit);
+            return;
+        }
+
+        // Строки разбиваются на части по старшим битам хеша, младшие биты используются внутри таблиц.
+        auto partition_of = [threads](size_t hash) { return (hash >> (sizeof(size_t) * 4)) % threads; };
+        std::vector<std::vector<size_t>> build_parts(threads);
+        std::vector<std::vector<size_t>> probe_parts(threads);
+        for (size_t row = 0; row < build_size; ++row)
+            build_parts[partition_of(KeyHash<Key>(get<BuildKey>(build[row])))].push_back(row);
+        for (size_t row = 0; row < probe_size; ++row)
+            probe_parts[partition_of(KeyHash<Key>(get<ProbeKey>(probe[row])))].push_back(row);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t part = 0; part < threads; ++part) {
+            workers.emplace_back([&, part] {
+                BuildAndProbe<BuildKey, ProbeKey, Key>(build, build_parts[part], probe, probe_parts[part], emit);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+    }
+}
+
+
+namespace zipcpp {
+    /* Внутреннее соединение двух объектов Zip по равенству столбцов KeyA (в zip_a) и KeyB (в zip_b).
+     * Хеш-таблица строится по номерам строк меньшего из диапазонов, второй диапазон используется для поиска.
+     * Для каждой пары совпавших строк вызывается emit(row_a, row_b), где row_a и row_b - кортежи ссылок
+     *  на элементы исходных контейнеров, т.е. значения столбцов не копируются.
+     * При threads > 1 строки обоих диапазонов разбиваются на threads частей по хешу ключа,
+     *  и каждая часть обрабатывается в отдельном потоке; в этом случае emit вызывается параллельно.
+     */
+    template <size_t KeyA, size_t KeyB, typename ZipA, typename ZipB, typename Emit>
+    void hash_join(ZipA&& zip_a, ZipB&& zip_b, Emit&& emit, size_t threads = 1) {
+        auto a = std::begin(zip_a);
+        auto b = std::begin(zip_b);
+        static_assert(std::is_convertible_v<typename decltype(a)::iterator_category, std::random_access_iterator_tag>);
+        static_assert(std::is_convertible_v<typename decltype(b)::iterator_category, std::random_access_iterator_tag>);
+
+        using KeyTypeA = std::decay_t<decltype(zip_impl::get<KeyA>(*a))>;
+        using KeyTypeB = std::decay_t<decltype(zip_impl::get<KeyB>(*b))>;
+        using Key = std::common_type_t<KeyTypeA, KeyTypeB>;
+
+        size_t size_a = zip_a.size();
+        size_t size_b = zip_b.size();
+        if (size_a <= size_b) {
+            zip_impl::HashJoin<KeyA, KeyB, Key>(a, size_a, b, size_b, emit, threads);
+        } else {
+            auto swapped = [&emit](auto& row_b, auto& row_a) { emit(row_a, row_b); };
+            zip_impl::HashJoin<KeyB, KeyA, Key>(b, size_b, a, size_a, swapped, threads);
+        }
+    }
+}
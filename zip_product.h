@@ -0,0 +1,279 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "zip.h"
+
+namespace zip_impl {
+    // Суммарный размер плиток всех диапазонов произведения: плитки помещаются в кэш первого уровня.
+    constexpr size_t kProductTileBytes = 32 * 1024;
+
+    template <typename Range>
+    using IteratorOf = std::remove_reference_t<decltype(std::begin(std::declval<Range>()))>;
+
+    /* Декартово произведение диапазонов: строки - кортежи Tuple из ссылок на элементы всех диапазонов.
+     * Если все диапазоны допускают произвольный доступ, то строки перебираются плитками: каждый диапазон делится
+     *  на отрезки, помещающиеся вместе в кэш, и все сочетания элементов текущих отрезков перебираются раньше,
+     *  чем следующие отрезки. Внутри плитки и между плитками порядок лексикографический (последний диапазон меняется быстрее всего),
+     *  поэтому небольшие диапазоны, помещающиеся в одну плитку, перебираются как вложенными циклами.
+     * Остальные диапазоны должны быть многопроходными, и строки перебираются вложенными циклами.
+     * Итераторы хранят указатель на объект Product, поэтому он должен существовать, пока используются его итераторы.
+     */
+    template <typename... Types>
+    class Product {
+        using stored_iterators_tuple = std::tuple<IteratorOf<Types>...>;
+        static constexpr size_t kRanges = sizeof...(Types);
+        using Extents = std::array<size_t, kRanges>;
+
+    public:
+        static constexpr bool tiled = std::conjunction_v<std::is_convertible<
+                typename std::iterator_traits<IteratorOf<Types>>::iterator_category,
+                std::random_access_iterator_tag>...>;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Tuple<typename value_helper<IteratorOf<Types>>::value...>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            iterator() = default;
+
+            inline value_type operator*() const { return Dereference(std::make_index_sequence<kRanges>{}); }
+
+            // На каждой строке, кроме последней строки отрезка внутреннего диапазона, выполняется только одно сравнение
+            //  итератора внутреннего диапазона с концом его отрезка; переход к следующему отрезку вынесен в Carry.
+            inline iterator& operator++() {
+                ++position_;
+                if (++std::get<kRanges - 1>(current_) == inner_limit_)
+                    Carry();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+
+            // Сравниваются только итераторы одного диапазона строк (всего произведения или одной плитки).
+            inline bool operator==(const iterator& other) const { return position_ == other.position_; }
+            inline bool operator!=(const iterator& other) const { return position_ != other.position_; }
+
+        private:
+            friend class Product;
+
+            iterator(const Product* product, const Extents& origin, size_t position)
+                    : product_(product), origin_(origin), position_(position) {
+                ResetAll(std::make_index_sequence<kRanges>{});
+            }
+
+            template <size_t... Indexes>
+            inline value_type Dereference(std::index_sequence<Indexes...>) const {
+                return value_type(*std::get<Indexes>(current_)...);
+            }
+
+            // Конец отрезка внутреннего диапазона пройден: переходит к следующему элементу внешних диапазонов внутри плитки
+            //  или к следующей плитке.
+            void Carry() {
+                Reset<kRanges - 1>();
+                if constexpr (kRanges > 1) {
+                    if (!StepIndex<kRanges - 2>())
+                        return;
+                }
+                NextTile();
+            }
+
+            // Переходит к следующему элементу K-го диапазона внутри плитки. Возвращает true, если перебор плитки закончен.
+            template <size_t K>
+            inline bool StepIndex() {
+                ++std::get<K>(current_);
+                if (++index_[K] < limit_[K])
+                    return false;
+                Reset<K>();
+                if constexpr (K == 0)
+                    return true;
+                else
+                    return StepIndex<K - 1>();
+            }
+
+            template <size_t K>
+            inline void Reset() {
+                index_[K] = origin_[K];
+                limit_[K] = std::min(origin_[K] + product_->tile_[K], product_->sizes_[K]);
+                std::get<K>(current_) = std::next(std::get<K>(product_->begin_),
+                                                  static_cast<difference_type>(origin_[K]));
+                if constexpr (K + 1 == kRanges)
+                    inner_limit_ = std::next(std::get<K>(current_), static_cast<difference_type>(limit_[K] - origin_[K]));
+            }
+
+            template <size_t... Indexes>
+            inline void ResetAll(std::index_sequence<Indexes...>) {
+                (Reset<Indexes>(), ...);
+            }
+
+            // Начало следующей плитки в лексикографическом порядке. После последней плитки итератор равен end().
+            void NextTile() {
+                for (size_t k = kRanges; k-- > 0;) {
+                    origin_[k] += product_->tile_[k];
+                    if (origin_[k] < product_->sizes_[k]) {
+                        ResetAll(std::make_index_sequence<kRanges>{});
+                        return;
+                    }
+                    origin_[k] = 0;
+                }
+            }
+
+            const Product* product_ = nullptr;
+            stored_iterators_tuple current_;
+            IteratorOf<std::tuple_element_t<kRanges - 1, std::tuple<Types...>>> inner_limit_{};
+            Extents index_{};
+            Extents limit_{};
+            Extents origin_{};
+            size_t position_ = 0;
+        };
+
+        constexpr explicit Product(Types&&... args)
+                : begin_(std::begin(args)...),
+                  sizes_{static_cast<size_t>(std::distance(std::begin(args), std::end(args)))...} {
+            static_assert(kRanges != 0, "product requires at least one range");
+            constexpr Extents element_sizes = {sizeof(typename std::iterator_traits<IteratorOf<Types>>::value_type)...};
+            rows_ = 1;
+            tiles_ = 1;
+            for (size_t k = 0; k < kRanges; ++k) {
+                if constexpr (tiled && kRanges > 1)
+                    tile_[k] = std::max<size_t>(1, kProductTileBytes / (kRanges * element_sizes[k]));
+                else
+                    tile_[k] = std::max<size_t>(1, sizes_[k]);
+                rows_ *= sizes_[k];
+                tiles_ *= (sizes_[k] + tile_[k] - 1) / tile_[k];
+            }
+        }
+
+        // Пустое произведение (один из диапазонов пуст) не содержит строк, и его начало совпадает с концом.
+        inline iterator begin() const {
+            if (rows_ == 0)
+                return end();
+            return iterator(this, Extents{}, 0);
+        }
+
+        inline iterator end() const { return EndAt(rows_); }
+
+        inline size_t size() const { return rows_; }
+
+        // Количество плиток и диапазон строк плитки с номером index. Плитки не пересекаются и вместе содержат все строки,
+        //  поэтому их можно обрабатывать независимо в разных потоках.
+        inline size_t tiles() const { return tiles_; }
+
+        zipcpp::IterRange<iterator> tile(size_t index) const {
+            Extents origin = TileOrigin(index);
+            size_t rows = 1;
+            for (size_t k = 0; k < kRanges; ++k)
+                rows *= std::min(origin[k] + tile_[k], sizes_[k]) - origin[k];
+            return zipcpp::IterRange<iterator>(iterator(this, origin, 0), EndAt(rows));
+        }
+
+        // Длина стороны плитки по K-му диапазону.
+        inline size_t tile_size(size_t k) const { return tile_[k]; }
+
+        // Вызывает f для каждой строки плитки с номером index вложенными циклами без проверок границ плитки на каждой строке,
+        //  что позволяет компилятору векторизовать внутренний цикл для простых f.
+        template <typename F>
+        void ForEachInTile(size_t index, F& f) const {
+            Extents origin = TileOrigin(index);
+            ForEachInTileImpl<0>(origin, begin_, f);
+        }
+
+    private:
+        inline Extents TileOrigin(size_t index) const {
+            Extents origin{};
+            for (size_t k = kRanges; k-- > 0;) {
+                size_t count = (sizes_[k] + tile_[k] - 1) / tile_[k];
+                origin[k] = index % count * tile_[k];
+                index /= count;
+            }
+            return origin;
+        }
+
+        template <size_t K, typename F, typename... Elements>
+        void ForEachInTileImpl(const Extents& origin, const stored_iterators_tuple& first, F& f, Elements&&... elements) const {
+            size_t last = std::min(origin[K] + tile_[K], sizes_[K]);
+            auto it = std::next(std::get<K>(first), static_cast<std::ptrdiff_t>(origin[K]));
+            for (size_t index = origin[K]; index < last; ++index, ++it) {
+                if constexpr (K + 1 == kRanges)
+                    f(typename iterator::value_type(std::forward<Elements>(elements)..., *it));
+                else
+                    ForEachInTileImpl<K + 1>(origin, first, f, std::forward<Elements>(elements)..., *it);
+            }
+        }
+
+        inline iterator EndAt(size_t position) const {
+            iterator it;
+            it.position_ = position;
+            return it;
+        }
+
+        stored_iterators_tuple begin_;
+        Extents sizes_;
+        Extents tile_{};
+        size_t rows_ = 0;
+        size_t tiles_ = 0;
+    };
+}
+
+
+namespace zipcpp {
+    /* Декартово произведение диапазонов: for (const auto& [x, y] : zipcpp::product(a, b)) перебирает все пары
+     *  элементов a и b. Для диапазонов с произвольным доступом строки перебираются плитками, помещающимися в кэш
+     *  (см. zip_impl::Product), поэтому порядок строк отличается от порядка вложенных циклов.
+     * Цикл по итераторам не векторизуется: для вычислений над всеми строками следует использовать for_each_tile.
+     */
+    template <typename... Types>
+    zip_impl::Product<Types...> product(Types&&... args) {
+        return zip_impl::Product<Types...>(std::forward<Types>(args)...);
+    }
+
+    /* Вызывает f для каждой строки произведения, перебирая плитки по очереди. В отличие от цикла по итераторам
+     *  внутри плитки выполняются обычные вложенные циклы, поэтому внутренний цикл векторизуется для простых f.
+     */
+    template <typename ProductType, typename F>
+    void for_each_tile(const ProductType& rows, F&& f) {
+        for (size_t index = 0; index < rows.tiles(); ++index)
+            rows.ForEachInTile(index, f);
+    }
+
+    /* Вызывает f для каждой строки произведения в threads потоках. Потоки по очереди забирают следующую
+     *  необработанную плитку, поэтому нагрузка распределяется равномерно и при разной стоимости f.
+     * f вызывается одновременно из нескольких потоков; порядок строк не определен.
+     */
+    template <typename ProductType, typename F>
+    void for_each_tile_parallel(const ProductType& rows, size_t threads, F&& f) {
+        size_t tiles = rows.tiles();
+        threads = std::min(threads, tiles);
+        if (threads <= 1) {
+            for_each_tile(rows, f);
+            return;
+        }
+
+        std::atomic<size_t> next_tile{0};
+        auto work = [&] {
+            for (size_t index = next_tile.fetch_add(1, std::memory_order_relaxed); index < tiles;
+                 index = next_tile.fetch_add(1, std::memory_order_relaxed))
+                rows.ForEachInTile(index, f);
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t part = 1; part < threads; ++part)
+            workers.emplace_back(work);
+        work();
+        for (auto& worker : workers)
+            worker.join();
+    }
+}
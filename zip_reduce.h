@@ -0,0 +1,315 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "zip.h"
+
+namespace zip_impl {
+
+    // Возвращает первый элемент из [first, last), не равный value.
+    // Элементы сравниваются блоками размером в кэш-линию без ветвлений внутри блока,
+    //  поэтому внутренний цикл векторизуется компилятором.
+    template <typename T>
+    const T* FindFirstNotEqual(const T* first, const T* last, T value) {
+        constexpr size_t block = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+        while (static_cast<size_t>(last - first) >= block) {
+            bool differs = false;
+            for (size_t i = 0; i < block; ++i)
+                differs |= first[i] != value;
+            if (differs)
+                break;
+            first += block;
+        }
+        while (first != last && *first == value)
+            ++first;
+        return first;
+    }
+
+    template <typename Iterator, size_t Column>
+    using column_iterator_t = std::tuple_element_t<Column, typename Iterator::Base>;
+
+    // Конец диапазона, выровненный так, что все хранимые итераторы смещены от начала на одинаковое расстояние.
+    // Для итераторов произвольного доступа это позволяет вычислять расстояние между итераторами по любому столбцу.
+    template <typename Source>
+    auto AlignedEnd(Source& source) {
+        auto last = std::end(source);
+        if constexpr (std::is_convertible_v<typename decltype(last)::iterator_category, std::random_access_iterator_tag>)
+            return std::begin(source) + static_cast<int>(source.size());
+        else
+            return last;
+    }
+
+    struct NoRowCallback {
+        template <typename Row>
+        inline void operator()(const Row&) const {}
+    };
+
+    // Находит конец группы строк с одинаковым значением столбца Key, начинающейся с first (first != last).
+    // Для всех строк группы, кроме первой, вызывается on_row.
+    // Если столбец ключа расположен в непрерывной памяти и имеет арифметический тип, граница ищется векторизованным
+    //  сравнением, и только затем выполняется проход по строкам группы.
+    template <size_t Key, typename Iterator, typename OnRow>
+    Iterator ScanSegment(Iterator first, const Iterator& last, OnRow&& on_row) {
+        using Column = column_iterator_t<Iterator, Key>;
+        using Value = typename std::iterator_traits<Column>::value_type;
+        if constexpr (std::is_convertible_v<typename Iterator::iterator_category, std::random_access_iterator_tag>
+                      && IsContiguousIterator<Column>::value && std::is_arithmetic_v<Value>) {
+            // Первая строка всегда входит в группу, даже если ключ не равен себе (NaN), поэтому поиск начинается со второй.
+            const Value* data = std::addressof(*std::get<Key>(first.AsTuple()));
+            const Value* found = FindFirstNotEqual(data + 1, data + (last - first), *data);
+            Iterator segment_end = first + static_cast<int>(found - data);
+            if constexpr (!std::is_same_v<std::decay_t<OnRow>, NoRowCallback>) {
+                while (++first != segment_end)
+                    on_row(*first);
+            }
+            return segment_end;
+        } else {
+            auto row = *first;
+            const auto& key = get<Key>(row);
+            while (++first != last) {
+                auto next = *first;
+                if (!(get<Key>(next) == key))
+                    break;
+                on_row(next);
+            }
+            return first;
+        }
+    }
+
+    template <size_t Key, typename Source>
+    class GroupByRange {
+        using zip_iterator = decltype(std::begin(std::declval<Source&>()));
+    public:
+        using key_reference = decltype(get<Key>(*std::declval<zip_iterator&>()));
+        using subrange_type = decltype(std::declval<Source&>().subrange(std::declval<zip_iterator>(), std::declval<zip_iterator>()));
+        using value_type = std::pair<key_reference, subrange_type>;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename GroupByRange::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = value_type*;
+            using reference = value_type;
+
+            iterator(const GroupByRange* range, zip_iterator first) : range_(range), first_(first), next_(first) {
+                if (first_ != range_->last_)
+                    next_ = ScanSegment<Key>(first_, range_->last_, NoRowCallback{});
+            }
+
+            value_type operator*() const {
+                auto it = first_;
+                auto row = *it;
+                return value_type(get<Key>(row), range_->source_.subrange(first_, next_));
+            }
+
+            iterator& operator++() {
+                first_ = next_;
+                if (first_ != range_->last_)
+                    next_ = ScanSegment<Key>(first_, range_->last_, NoRowCallback{});
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+
+            bool operator==(const iterator& other) const { return first_ == other.first_; }
+            bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            const GroupByRange* range_;
+            zip_iterator first_;
+            zip_iterator next_;
+        };
+
+        explicit GroupByRange(const Source& source) : source_(source), first_(std::begin(source_)), last_(AlignedEnd(source_)) {}
+
+        iterator begin() const { return iterator(this, first_); }
+        iterator end() const { return iterator(this, last_); }
+
+    private:
+        Source source_;
+        zip_iterator first_;
+        zip_iterator last_;
+    };
+
+    template <size_t Key, typename Source, typename... Ops>
+    class SegmentedReduceRange {
+        using zip_iterator = decltype(std::begin(std::declval<Source&>()));
+        using row_type = decltype(*std::declval<zip_iterator&>());
+    public:
+        using key_reference = decltype(get<Key>(std::declval<row_type>()));
+        using value_type = std::tuple<key_reference, decltype(std::declval<const Ops&>().init(std::declval<row_type>()))...>;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename SegmentedReduceRange::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+            iterator(const SegmentedReduceRange* range, zip_iterator first) : range_(range), first_(first), next_(first) {
+                Reduce();
+            }
+
+            const value_type& operator*() const { return *value_; }
+            const value_type* operator->() const { return &*value_; }
+
+            iterator& operator++() {
+                first_ = next_;
+                Reduce();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto it = *this;
+                ++(*this);
+                return it;
+            }
+
+            bool operator==(const iterator& other) const { return first_ == other.first_; }
+            bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            // Все агрегаты группы вычисляются за один проход по ее строкам без промежуточных контейнеров.
+            void Reduce() {
+                if (first_ == range_->last_)
+                    return;
+                auto it = first_;
+                auto row = *it;
+                std::apply([&](const auto&... ops) { value_.emplace(get<Key>(row), ops.init(row)...); }, range_->ops_);
+                next_ = ScanSegment<Key>(first_, range_->last_, [this](const auto& next) {
+                    Update(next, std::index_sequence_for<Ops...>{});
+                });
+            }
+
+            template <typename Row, size_t... Indexes>
+            inline void Update(const Row& row, std::index_sequence<Indexes...>) {
+                (std::get<Indexes>(range_->ops_).update(std::get<Indexes + 1>(*value_), row), ...);
+            }
+
+            const SegmentedReduceRange* range_;
+            zip_iterator first_;
+            zip_iterator next_;
+            std::optional<value_type> value_;
+        };
+
+        SegmentedReduceRange(const Source& source, Ops... ops)
+                : source_(source), first_(std::begin(source_)), last_(AlignedEnd(source_)), ops_(std::move(ops)...) {}
+
+        iterator begin() const { return iterator(this, first_); }
+        iterator end() const { return iterator(this, last_); }
+
+    private:
+        Source source_;
+        zip_iterator first_;
+        zip_iterator last_;
+        std::tuple<Ops...> ops_;
+    };
+}
+
+
+namespace zipcpp {
+    /* Агрегаты для segmented_reduce и hash_aggregate. Метод init создает состояние агрегата по первой строке группы,
+     *  метод update учитывает в состоянии очередную строку, метод merge объединяет два состояния одной группы.
+     */
+    template <size_t Column>
+    struct sum_of {
+        template <typename Row>
+        auto init(const Row& row) const {
+            return std::decay_t<decltype(zip_impl::get<Column>(row))>(zip_impl::get<Column>(row));
+        }
+
+        template <typename State, typename Row>
+        void update(State& state, const Row& row) const {
+            state += zip_impl::get<Column>(row);
+        }
+
+        template <typename State>
+        void merge(State& state, const State& other) const {
+            state += other;
+        }
+    };
+
+    template <size_t Column>
+    struct min_of {
+        template <typename Row>
+        auto init(const Row& row) const {
+            return std::decay_t<decltype(zip_impl::get<Column>(row))>(zip_impl::get<Column>(row));
+        }
+
+        template <typename State, typename Row>
+        void update(State& state, const Row& row) const {
+            if (zip_impl::get<Column>(row) < state)
+                state = zip_impl::get<Column>(row);
+        }
+
+        template <typename State>
+        void merge(State& state, const State& other) const {
+            if (other < state)
+                state = other;
+        }
+    };
+
+    template <size_t Column>
+    struct max_of {
+        template <typename Row>
+        auto init(const Row& row) const {
+            return std::decay_t<decltype(zip_impl::get<Column>(row))>(zip_impl::get<Column>(row));
+        }
+
+        template <typename State, typename Row>
+        void update(State& state, const Row& row) const {
+            if (state < zip_impl::get<Column>(row))
+                state = zip_impl::get<Column>(row);
+        }
+
+        template <typename State>
+        void merge(State& state, const State& other) const {
+            if (state < other)
+                state = other;
+        }
+    };
+
+    struct row_count {
+        template <typename Row>
+        size_t init(const Row&) const {
+            return 1;
+        }
+
+        template <typename Row>
+        void update(size_t& state, const Row&) const {
+            ++state;
+        }
+
+        void merge(size_t& state, size_t other) const {
+            state += other;
+        }
+    };
+
+    /* Ленивый диапазон групп подряд идущих строк с равными значениями столбца Key.
+     * Каждый элемент - пара из ссылки на значение ключа и объекта Zip, представляющего строки группы.
+     * Для получения группировки по всем равным ключам диапазон должен быть предварительно отсортирован по столбцу Key.
+     */
+    template <size_t Key, typename ZipType>
+    auto group_by(ZipType&& rows) {
+        return zip_impl::GroupByRange<Key, std::remove_reference_t<ZipType>>(rows);
+    }
+
+    /* Ленивый диапазон агрегатов по тем же группам, что и group_by.
+     * Каждый элемент - кортеж из ссылки на значение ключа и состояний переданных агрегатов, например:
+     *   for (const auto& [key, total, smallest, count] : segmented_reduce<0>(z, sum_of<1>{}, min_of<2>{}, row_count{}))
+     */
+    template <size_t Key, typename ZipType, typename... Ops>
+    auto segmented_reduce(ZipType&& rows, Ops... ops) {
+        return zip_impl::SegmentedReduceRange<Key, std::remove_reference_t<ZipType>, Ops...>(rows, std::move(ops)...);
+    }
+}
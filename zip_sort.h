@@ -0,0 +1,431 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "zip.h"
+#include "zip_io.h"
+
+/* Внешняя сортировка строк, которые не помещаются в память (POSIX): строки читаются частями в пределах бюджета памяти,
+ *  каждая часть сортируется и записывается во временный файл в формате write_columns (серия), а затем серии
+ *  сливаются с помощью дерева проигравших. Запись серии выполняется в фоновом потоке, пока читается следующая часть,
+ *  а при слиянии фоновый поток читает следующие блоки серий, пока обходятся текущие.
+ */
+
+namespace zip_impl {
+    // Наименьшее количество строк блока серии, читаемого за один раз при слиянии.
+    inline constexpr size_t kMinMergeBlockRows = 256;
+
+    template <typename... Values>
+    using ColumnBuffers = std::tuple<std::vector<Values>...>;
+
+    // Временные файлы серий; удаляются деструктором, в том числе при исключении.
+    class SpillFiles {
+    public:
+        explicit SpillFiles(const std::string& directory) : directory_(directory) {
+            if (directory_.empty()) {
+                const char* temp = std::getenv("TMPDIR");
+                directory_ = temp != nullptr && *temp != '\0' ? temp : "/tmp";
+            }
+        }
+
+        SpillFiles(const SpillFiles&) = delete;
+        SpillFiles& operator=(const SpillFiles&) = delete;
+
+        ~SpillFiles() {
+            for (const auto& path : paths_)
+                ::unlink(path.c_str());
+        }
+
+        std::string Add() {
+            static std::atomic<unsigned> counter{0};
+            paths_.push_back(directory_ + "/zipcpp_run_" + std::to_string(::getpid()) + "_" + std::to_string(counter++));
+            return paths_.back();
+        }
+
+        inline const std::vector<std::string>& paths() const { return paths_; }
+
+    private:
+        std::string directory_;
+        std::vector<std::string> paths_;
+    };
+
+    // Фоновый поток, исключение которого передается вызывающему потоку при ожидании завершения.
+    class BackgroundTask {
+    public:
+        BackgroundTask() = default;
+        BackgroundTask(const BackgroundTask&) = delete;
+        BackgroundTask& operator=(const BackgroundTask&) = delete;
+
+        ~BackgroundTask() {
+            if (thread_.joinable())
+                thread_.join();
+        }
+
+        template <typename F>
+        void Start(F f) {
+            Wait();
+            thread_ = std::thread([this, f = std::move(f)]() mutable {
+                try {
+                    f();
+                } catch (...) {
+                    error_ = std::current_exception();
+                }
+            });
+        }
+
+        void Wait() {
+            if (thread_.joinable())
+                thread_.join();
+            if (error_)
+                std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+
+    private:
+        std::thread thread_;
+        std::exception_ptr error_;
+    };
+
+    // Номера строк части в порядке возрастания столбца K; строки с равными ключами сохраняют исходный порядок.
+    template <size_t K, typename... Values>
+    void SortOrder(const ColumnBuffers<Values...>& columns, std::vector<uint32_t>& order) {
+        const auto& keys = std::get<K>(columns);
+        order.resize(keys.size());
+        std::iota(order.begin(), order.end(), uint32_t{0});
+        std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    }
+
+    /* Переставляет строки части в порядке order на месте, обходя циклы перестановки: каждая строка перемещается
+     *  один раз, а дополнительная память нужна только для одной строки. После перестановки order[i] == i.
+     */
+    template <typename... Values, size_t... Indexes>
+    void ApplyOrder(ColumnBuffers<Values...>& columns, std::vector<uint32_t>& order, std::index_sequence<Indexes...>) {
+        for (size_t first = 0; first < order.size(); ++first) {
+            if (order[first] == first)
+                continue;
+            std::tuple<Values...> saved(std::get<Indexes>(columns)[first]...);
+            size_t hole = first;
+            for (size_t source = order[hole]; source != first; source = order[hole]) {
+                ((std::get<Indexes>(columns)[hole] = std::get<Indexes>(columns)[source]), ...);
+                order[hole] = static_cast<uint32_t>(hole);
+                hole = source;
+            }
+            ((std::get<Indexes>(columns)[hole] = std::get<Indexes>(saved)), ...);
+            order[hole] = static_cast<uint32_t>(hole);
+        }
+    }
+
+    /* Слияние серий. Каждая серия читается блоками по block_rows строк в два буфера: пока слияние обходит один,
+     *  фоновый поток читает в другой следующий блок, по одному вызову pread на столбец. Серия с наименьшим ключом
+     *  текущей строки выбирается деревом проигравших за log2(количества серий) сравнений; при равных ключах первой
+     *  выбирается серия с меньшим номером, поэтому сортировка устойчива.
+     */
+    template <size_t K, typename... Values>
+    class RunMerge {
+        static constexpr size_t kColumns = sizeof...(Values);
+
+        struct Run {
+            explicit Run(const std::string& path) : file(path, O_RDONLY) {}
+
+            FileDescriptor file;
+            uint64_t rows = 0;
+            uint64_t offsets[kColumns] = {};
+            // Следующая непрочитанная строка; используется только фоновым потоком.
+            uint64_t next = 0;
+            ColumnBuffers<Values...> buffers[2];
+            // Защищены mutex_.
+            size_t counts[2] = {0, 0};
+            bool ready[2] = {false, false};
+            // Используются только потоком слияния.
+            int current = 0;
+            size_t position = 0;
+            bool done = false;
+        };
+
+    public:
+        RunMerge(const std::vector<std::string>& paths, size_t block_rows) : block_rows_(block_rows) {
+            for (const auto& path : paths) {
+                runs_.push_back(std::make_unique<Run>(path));
+                Open(*runs_.back(), std::index_sequence_for<Values...>{});
+            }
+            reader_ = std::thread([this] { Read(); });
+        }
+
+        RunMerge(const RunMerge&) = delete;
+        RunMerge& operator=(const RunMerge&) = delete;
+
+        ~RunMerge() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            requested_.notify_all();
+            reader_.join();
+        }
+
+        template <typename Sink>
+        size_t Merge(Sink& sink) {
+            size_t count = runs_.size();
+            for (size_t r = 0; r < count; ++r) {
+                Request(r, 0);
+                Request(r, 1);
+            }
+            for (size_t r = 0; r < count; ++r)
+                Acquire(*runs_[r], 0);
+            Build();
+
+            size_t rows = 0;
+            while (!runs_[tree_[0]]->done) {
+                size_t winner = tree_[0];
+                Emit(*runs_[winner], sink, std::index_sequence_for<Values...>{});
+                ++rows;
+                Advance(winner);
+                Replay(winner);
+            }
+            return rows;
+        }
+
+    private:
+        template <size_t... Indexes>
+        void Open(Run& run, std::index_sequence<Indexes...>) {
+            ColumnFileHeader header{};
+            PreadAll(run.file.get(), &header, sizeof(header), 0);
+            ColumnDescriptor descriptors[kColumns];
+            PreadAll(run.file.get(), descriptors, sizeof(descriptors), sizeof(header));
+            run.rows = header.rows;
+            for (size_t k = 0; k < kColumns; ++k)
+                run.offsets[k] = descriptors[k].offset;
+            for (auto& buffer : run.buffers)
+                (std::get<Indexes>(buffer).resize(block_rows_), ...);
+        }
+
+        template <size_t... Indexes>
+        size_t Fill(Run& run, int buffer, std::index_sequence<Indexes...>) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(block_rows_, run.rows - run.next));
+            if (count != 0) {
+                (PreadAll(run.file.get(), std::get<Indexes>(run.buffers[buffer]).data(), count * sizeof(Values),
+                          static_cast<off_t>(run.offsets[Indexes] + run.next * sizeof(Values))), ...);
+            }
+            run.next += count;
+            return count;
+        }
+
+        // Фоновый поток: читает блоки в порядке запросов.
+        void Read() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                requested_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (stop_)
+                    return;
+                auto [run, buffer] = queue_.front();
+                queue_.pop_front();
+                lock.unlock();
+                size_t count = 0;
+                std::exception_ptr error;
+                try {
+                    count = Fill(*runs_[run], buffer, std::index_sequence_for<Values...>{});
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                lock.lock();
+                runs_[run]->counts[buffer] = count;
+                runs_[run]->ready[buffer] = true;
+                if (error)
+                    error_ = error;
+                filled_.notify_all();
+            }
+        }
+
+        void Request(size_t run, int buffer) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.emplace_back(run, buffer);
+            }
+            requested_.notify_one();
+        }
+
+        void Acquire(Run& run, int buffer) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            filled_.wait(lock, [&] { return run.ready[buffer]; });
+            if (error_)
+                std::rethrow_exception(error_);
+            run.ready[buffer] = false;
+            run.current = buffer;
+            run.position = 0;
+            run.done = run.counts[buffer] == 0;
+        }
+
+        // Переход к следующей строке серии; прочитанный буфер отдается фоновому потоку для следующего блока.
+        void Advance(size_t index) {
+            Run& run = *runs_[index];
+            if (++run.position == run.counts[run.current]) {
+                int consumed = run.current;
+                Request(index, consumed);
+                Acquire(run, consumed ^ 1);
+            }
+        }
+
+        template <typename Sink, size_t... Indexes>
+        void Emit(const Run& run, Sink& sink, std::index_sequence<Indexes...>) {
+            const auto& buffer = run.buffers[run.current];
+            sink(Tuple<const Values&...>(std::get<Indexes>(buffer)[run.position]...));
+        }
+
+        // Текущая строка серии a должна быть выведена раньше текущей строки серии b; закончившиеся серии - последние.
+        inline bool Less(size_t a, size_t b) const {
+            const Run& x = *runs_[a];
+            const Run& y = *runs_[b];
+            if (x.done || y.done)
+                return !x.done;
+            const auto& key_x = std::get<K>(x.buffers[x.current])[x.position];
+            const auto& key_y = std::get<K>(y.buffers[y.current])[y.position];
+            if (key_x < key_y)
+                return true;
+            if (key_y < key_x)
+                return false;
+            return a < b;
+        }
+
+        // Узлы 1..k-1 хранят проигравших в соответствующих сравнениях, узел 0 - победителя; серия r - лист k + r.
+        void Build() {
+            size_t count = runs_.size();
+            tree_.assign(count, 0);
+            std::vector<size_t> winners(2 * count);
+            for (size_t r = 0; r < count; ++r)
+                winners[count + r] = r;
+            for (size_t node = count - 1; node > 0; --node) {
+                size_t a = winners[2 * node];
+                size_t b = winners[2 * node + 1];
+                if (Less(b, a))
+                    std::swap(a, b);
+                winners[node] = a;
+                tree_[node] = b;
+            }
+            tree_[0] = count > 1 ? winners[1] : 0;
+        }
+
+        // После перехода серии winner к следующей строке сравнения повторяются только на пути от ее листа к корню.
+        void Replay(size_t winner) {
+            for (size_t node = (winner + runs_.size()) / 2; node > 0; node /= 2) {
+                if (Less(tree_[node], winner))
+                    std::swap(tree_[node], winner);
+            }
+            tree_[0] = winner;
+        }
+
+        size_t block_rows_;
+        std::vector<std::unique_ptr<Run>> runs_;
+        std::vector<size_t> tree_;
+
+        std::mutex mutex_;
+        std::condition_variable requested_;
+        std::condition_variable filled_;
+        std::deque<std::pair<size_t, int>> queue_;
+        std::exception_ptr error_;
+        bool stop_ = false;
+        std::thread reader_;
+    };
+
+    template <size_t K, typename Rows, typename Sink, typename... Values, size_t... Indexes>
+    size_t ExternalSort(Rows& rows, Sink& sink, size_t memory_budget, const std::string& directory,
+                        std::tuple<Values...>*, std::index_sequence<Indexes...>) {
+        static_assert(K < sizeof...(Values), "external_sort_by<K> requires K to be a column index");
+        static_assert(std::conjunction_v<std::is_trivially_copyable<Values>...>
+                              && !std::disjunction_v<std::is_same<Values, bool>...>,
+                      "external_sort_by requires trivially copyable column values other than bool");
+        constexpr size_t kRowBytes = (sizeof(Values) + ...);
+
+        // Одна часть заполняется, пока предыдущая сортируется и записывается, поэтому каждой достается половина бюджета.
+        size_t run_rows = std::max<size_t>(1, memory_budget / (2 * (kRowBytes + sizeof(uint32_t))));
+        run_rows = std::min<size_t>(run_rows, UINT32_MAX);
+        ColumnBuffers<Values...> chunks[2];
+        std::vector<uint32_t> orders[2];
+        SpillFiles files(directory);
+        BackgroundTask spill;
+        int filling = 0;
+        size_t total = 0;
+
+        auto start_spill = [&] {
+            spill.Wait();
+            int spilled = filling;
+            spill.Start([&columns = chunks[spilled], &order = orders[spilled], path = files.Add()] {
+                // Строки переставляются на месте, и столбцы записываются из непрерывной памяти без промежуточного буфера.
+                SortOrder<K>(columns, order);
+                ApplyOrder(columns, order, std::index_sequence<Indexes...>{});
+                zipcpp::write_columns(path, zipcpp::zip(std::get<Indexes>(columns)...));
+            });
+            filling ^= 1;
+            (std::get<Indexes>(chunks[filling]).clear(), ...);
+            (std::get<Indexes>(chunks[filling]).reserve(run_rows), ...);
+        };
+
+        (std::get<Indexes>(chunks[0]).reserve(run_rows), ...);
+        // Заполненная часть записывается, только если за ней есть еще строки: иначе все строки могут уместиться в одну часть.
+        auto it = std::begin(rows);
+        auto end = std::end(rows);
+        while (it != end) {
+            {
+                auto&& row = *it;
+                (std::get<Indexes>(chunks[filling]).push_back(static_cast<Values>(RowElement<Indexes>(row))), ...);
+            }
+            ++it;
+            if (++total % run_rows == 0 && it != end)
+                start_spill();
+        }
+
+        auto& last = chunks[filling];
+        if (files.paths().empty()) {
+            // Все строки поместились в одну часть: временные файлы не нужны.
+            SortOrder<K>(last, orders[filling]);
+            for (uint32_t index : orders[filling])
+                sink(Tuple<const Values&...>(std::get<Indexes>(last)[index]...));
+            return total;
+        }
+        if (!std::get<0>(last).empty())
+            start_spill();
+        spill.Wait();
+        for (auto& chunk : chunks)
+            chunk = ColumnBuffers<Values...>();
+        for (auto& order : orders)
+            order = std::vector<uint32_t>();
+
+        size_t runs = files.paths().size();
+        size_t block_rows = std::max(kMinMergeBlockRows, memory_budget / (2 * runs * kRowBytes));
+        RunMerge<K, Values...> merge(files.paths(), block_rows);
+        return merge.Merge(sink);
+    }
+}
+
+
+namespace zipcpp {
+    /* Сортирует строки rows (например, zip(columns...) из генераторов или потоков) по возрастанию столбца с номером K
+     *  и передает их по порядку в sink(row), где row - кортеж константных ссылок на значения строки, действительных
+     *  до возврата из sink. Строки с равными ключами передаются в исходном порядке.
+     * Строки читаются частями, занимающими не больше memory_budget байтов вместе с сортируемой частью; если все строки
+     *  помещаются в одну часть, они сортируются в памяти. Иначе строки каждой части переставляются на месте в порядке
+     *  сортировки и записываются в фоновом потоке во временный файл в каталоге directory (по умолчанию $TMPDIR
+     *  или /tmp) в формате write_columns, пока читается следующая часть, а затем файлы сливаются деревом проигравших
+     *  с чтением блоков в фоновом потоке. Блок серии содержит не меньше 256 строк, поэтому при очень большом количестве
+     *  серий бюджет памяти при слиянии может быть превышен.
+     * Значения столбцов должны быть тривиально копируемыми. Возвращает количество строк.
+     */
+    template <size_t K, typename Rows, typename Sink>
+    size_t external_sort_by(Rows&& rows, Sink sink, size_t memory_budget, const std::string& directory = std::string()) {
+        using Iterator = decltype(std::begin(rows));
+        using Values = typename zip_impl::ZipColumnValues<Iterator>::values;
+        return zip_impl::ExternalSort<K>(rows, sink, memory_budget, directory, static_cast<Values*>(nullptr),
+                                         std::make_index_sequence<std::tuple_size_v<Values>>{});
+    }
+}
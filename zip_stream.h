@@ -0,0 +1,324 @@
+#pragma once
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "zip.h"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if __has_include(<linux/membarrier.h>)
+#include <linux/membarrier.h>
+#endif
+#endif
+
+/* Поток значений между двумя потоками выполнения: кольцевой буфер с одним производителем и одним потребителем.
+ * Сторона потребителя является диапазоном ввода, поэтому несколько потоков можно обходить в zip построчно.
+ */
+
+namespace zip_impl {
+    // Размер строки кэша: счетчики производителя и потребителя хранятся в разных строках.
+    constexpr size_t kCacheLine = 64;
+
+    // Количество проверок условия перед тем, как поток выполнения засыпает.
+    constexpr int kStreamSpinCount = 1024;
+
+    inline void SpinPause() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    // Ожидание и пробуждение по 32-битному слову: futex в Linux, уступка процессора в остальных системах.
+    inline void FutexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        if (word.load(std::memory_order_acquire) == expected)
+            std::this_thread::yield();
+#endif
+    }
+
+    inline void FutexWakeAll(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+
+    /* Асимметричный барьер для проверки флага ожидания: сторона, которая засыпает, выполняет тяжелый барьер
+     *  (membarrier, который выполняет полный барьер на всех потоках процесса), а сторона, которая изменяет состояние
+     *  на каждом элементе, - только барьер компилятора. Если membarrier недоступен, обе стороны выполняют полный барьер.
+     * Без futex ожидающая сторона не засыпает, а перепроверяет условие, поэтому барьер не нужен.
+     */
+    inline bool RegisterHeavyBarrier() {
+#if defined(__linux__) && defined(SYS_membarrier) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+        return syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+    inline const bool kHeavyBarrierAvailable = RegisterHeavyBarrier();
+
+    inline void HeavyBarrier() {
+#if defined(__linux__) && defined(SYS_membarrier) && defined(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+        if (kHeavyBarrierAvailable && syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) == 0)
+            return;
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    inline void LightBarrier() {
+#if defined(__linux__)
+        if (!kHeavyBarrierAvailable) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return;
+        }
+#endif
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    /* Ждет выполнения ready(): сначала ограниченное число проверок с паузой, затем сон на флаге waiting.
+     * Флаг выставляется до последней проверки, между ними выполняется тяжелый барьер, а другая сторона после
+     *  изменения состояния проверяет флаг после легкого барьера (см. Notify), поэтому пробуждение не теряется.
+     */
+    // На одном процессоре другая сторона не может изменить состояние, пока ожидающий поток крутится.
+    inline int StreamSpinCount() {
+        static const int count = std::thread::hardware_concurrency() > 1 ? kStreamSpinCount : 0;
+        return count;
+    }
+
+    template <typename Ready>
+    void SpinThenWait(std::atomic<uint32_t>& waiting, Ready&& ready) {
+        for (int i = 0, spins = StreamSpinCount(); i < spins; ++i) {
+            if (ready())
+                return;
+            SpinPause();
+        }
+        while (!ready()) {
+            waiting.store(1, std::memory_order_relaxed);
+            HeavyBarrier();
+            if (ready()) {
+                waiting.store(0, std::memory_order_relaxed);
+                return;
+            }
+            FutexWait(waiting, 1);
+        }
+    }
+
+    // Будит сторону, спящую на флаге waiting. Вызывается после публикации нового состояния; пока флаг не выставлен,
+    //  стоит только барьера компилятора и чтения флага, поэтому вызывается на каждом элементе.
+    inline void Notify(std::atomic<uint32_t>& waiting) {
+        LightBarrier();
+        if (waiting.load(std::memory_order_relaxed) != 0 && waiting.exchange(0, std::memory_order_relaxed) != 0)
+            FutexWakeAll(waiting);
+    }
+}
+
+
+namespace zipcpp {
+    /* Кольцевой буфер без блокировок с одним производителем и одним потребителем.
+     * Производитель вызывает push и по окончании данных close(). Потребитель обходит поток как диапазон ввода:
+     *   for (const auto& [price, quote] : zipcpp::zip(prices, quotes)) ...
+     *  строка возвращается, как только в каждом потоке появляется следующее значение, а обход заканчивается,
+     *  когда закрыт и исчерпан любой из потоков.
+     * Каждая сторона запоминает последнее прочитанное значение счетчика другой стороны и перечитывает его, только когда
+     *  запомненные элементы (или свободные места) закончились, а потребитель освобождает места порциями по четверти
+     *  буфера, поэтому строки кэша со счетчиками не передаются между ядрами на каждом элементе.
+     * Ожидающая сторона сначала крутится ограниченное время, затем засыпает на futex. Перед сном она выполняет
+     *  membarrier, поэтому push проверяет флаг ожидания потребителя без барьера процессора.
+     * close() может вызвать и потребитель, если прекращает чтение: тогда push возвращает false и не блокируется.
+     */
+    template <typename T>
+    class spsc_stream {
+    public:
+        using value_type = T;
+
+        // Емкость округляется вверх до степени двойки.
+        explicit spsc_stream(size_t capacity = 1024) {
+            capacity_ = 2;
+            while (capacity_ < capacity)
+                capacity_ *= 2;
+            mask_ = capacity_ - 1;
+            release_step_ = capacity_ / 4;
+            slots_ = std::allocator<T>().allocate(capacity_);
+        }
+
+        spsc_stream(const spsc_stream&) = delete;
+        spsc_stream& operator=(const spsc_stream&) = delete;
+
+        ~spsc_stream() {
+            size_t tail = producer_.tail.load(std::memory_order_relaxed);
+            for (size_t index = consumer_.head; index != tail; ++index)
+                slots_[index & mask_].~T();
+            std::allocator<T>().deallocate(slots_, capacity_);
+        }
+
+        // Добавляет значение, ожидая свободного места. Возвращает false, если поток закрыт.
+        bool push(const T& value) { return Emplace(value); }
+        bool push(T&& value) { return Emplace(std::move(value)); }
+
+        template <typename... Args>
+        bool emplace(Args&&... args) { return Emplace(std::forward<Args>(args)...); }
+
+        // Добавляет значение, только если есть свободное место.
+        bool try_push(const T& value) {
+            if (closed() || !HasSpace())
+                return false;
+            Publish(value);
+            return true;
+        }
+
+        // Конец потока. Элементы, добавленные до close(), остаются доступны потребителю.
+        void close() {
+            closed_.store(true, std::memory_order_release);
+            zip_impl::Notify(waiting_.consumer);
+            zip_impl::Notify(waiting_.producer);
+        }
+
+        inline bool closed() const { return closed_.load(std::memory_order_acquire); }
+        inline size_t capacity() const { return capacity_; }
+
+        // Все копии итератора разделяют позицию потребителя, как и положено итераторам ввода.
+        // Итератор, созданный конструктором по умолчанию, обозначает конец потока.
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            iterator() = default;
+            explicit iterator(spsc_stream* stream) : stream_(stream) {}
+
+            inline reference operator*() const { return stream_->Front(); }
+            inline pointer operator->() const { return std::addressof(stream_->Front()); }
+
+            iterator& operator++() {
+                stream_->Pop();
+                stream_->WaitForData();
+                return *this;
+            }
+
+            void operator++(int) { ++(*this); }
+
+            bool operator==(const iterator& other) const { return Done() == other.Done(); }
+            bool operator!=(const iterator& other) const { return !operator==(other); }
+
+        private:
+            inline bool Done() const { return stream_ == nullptr || !stream_->HasData(); }
+
+            spsc_stream* stream_ = nullptr;
+        };
+
+        // Ожидает первого значения или закрытия потока.
+        iterator begin() {
+            WaitForData();
+            return iterator(this);
+        }
+
+        iterator end() { return iterator(); }
+
+    private:
+        template <typename... Args>
+        bool Emplace(Args&&... args) {
+            if (closed())
+                return false;
+            if (!HasSpace()) {
+                zip_impl::SpinThenWait(waiting_.producer, [this] { return HasSpace() || closed(); });
+                if (closed())
+                    return false;
+            }
+            Publish(std::forward<Args>(args)...);
+            return true;
+        }
+
+        // Есть ли свободное место. Счетчик потребителя перечитывается, только когда запомненные места закончились.
+        inline bool HasSpace() {
+            size_t tail = producer_.tail.load(std::memory_order_relaxed);
+            if (tail - producer_.cached_head < capacity_)
+                return true;
+            producer_.cached_head = consumer_.released.load(std::memory_order_acquire);
+            return tail - producer_.cached_head < capacity_;
+        }
+
+        template <typename... Args>
+        void Publish(Args&&... args) {
+            size_t tail = producer_.tail.load(std::memory_order_relaxed);
+            new (slots_ + (tail & mask_)) T(std::forward<Args>(args)...);
+            producer_.tail.store(tail + 1, std::memory_order_release);
+            zip_impl::Notify(waiting_.consumer);
+        }
+
+        // Есть ли значение в текущей позиции. Счетчик производителя перечитывается, только когда запомненные
+        //  значения закончились; перед этим потребитель возвращает производителю прочитанные места.
+        inline bool HasData() {
+            if (consumer_.head != consumer_.cached_tail)
+                return true;
+            Release();
+            consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+            return consumer_.head != consumer_.cached_tail;
+        }
+
+        void WaitForData() {
+            if (HasData())
+                return;
+            zip_impl::SpinThenWait(waiting_.consumer, [this] { return HasData() || closed(); });
+            // Значения, добавленные до close(), должны быть прочитаны и после закрытия.
+            HasData();
+        }
+
+        inline T& Front() { return slots_[consumer_.head & mask_]; }
+
+        inline void Pop() {
+            slots_[consumer_.head & mask_].~T();
+            ++consumer_.head;
+            if (consumer_.head - consumer_.released.load(std::memory_order_relaxed) >= release_step_)
+                Release();
+        }
+
+        inline void Release() {
+            if (consumer_.released.load(std::memory_order_relaxed) == consumer_.head)
+                return;
+            consumer_.released.store(consumer_.head, std::memory_order_release);
+            zip_impl::Notify(waiting_.producer);
+        }
+
+        struct alignas(zip_impl::kCacheLine) ProducerState {
+            std::atomic<size_t> tail{0};
+            size_t cached_head = 0;
+        };
+
+        struct alignas(zip_impl::kCacheLine) ConsumerState {
+            size_t head = 0;
+            size_t cached_tail = 0;
+            std::atomic<size_t> released{0};
+        };
+
+        // Флаги ожидания меняются редко, поэтому хранятся отдельно от счетчиков, изменяемых на каждом элементе.
+        struct alignas(zip_impl::kCacheLine) WaitState {
+            std::atomic<uint32_t> producer{0};
+            std::atomic<uint32_t> consumer{0};
+        };
+
+        ProducerState producer_;
+        ConsumerState consumer_;
+        WaitState waiting_;
+        std::atomic<bool> closed_{false};
+        T* slots_ = nullptr;
+        size_t capacity_ = 0;
+        size_t mask_ = 0;
+        size_t release_step_ = 0;
+    };
+}
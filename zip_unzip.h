@@ -0,0 +1,328 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "zip.h"
+
+namespace zip_impl {
+
+    // Элемент строки с номером Index: строками могут быть кортежи Zip, std::tuple, std::pair
+    //  и любые типы с функцией get<Index>, находимой через ADL.
+    template <size_t Index, typename Row>
+    constexpr decltype(auto) RowElement(Row&& row) {
+        using std::get;
+        return get<Index>(std::forward<Row>(row));
+    }
+
+    inline constexpr size_t kUnknownSize = static_cast<size_t>(-1);
+
+    template <typename Range, typename = void>
+    struct HasSizeMethod : public std::false_type {};
+
+    template <typename Range>
+    struct HasSizeMethod<Range, std::void_t<decltype(std::declval<const Range&>().size())>> : public std::true_type {};
+
+    template <typename Container, typename = void>
+    struct HasReserveMethod : public std::false_type {};
+
+    template <typename Container>
+    struct HasReserveMethod<Container, std::void_t<decltype(std::declval<Container&>().reserve(size_t{}))>> : public std::true_type {};
+
+    template <typename Range>
+    using range_iterator_t = decltype(std::begin(std::declval<Range&>()));
+
+    template <typename Range>
+    inline constexpr bool kRandomAccessRange = std::is_convertible_v<
+            typename std::iterator_traits<range_iterator_t<Range>>::iterator_category, std::random_access_iterator_tag>;
+
+    // Длину диапазона можно узнать до обхода, если у него есть метод size() или итераторы произвольного доступа.
+    template <typename Range>
+    inline constexpr bool kSizedRange = HasSizeMethod<Range>::value || kRandomAccessRange<Range>;
+
+    template <typename Range>
+    size_t RangeSize(Range& range) {
+        if constexpr (HasSizeMethod<Range>::value)
+            return static_cast<size_t>(range.size());
+        else
+            return static_cast<size_t>(std::distance(std::begin(range), std::end(range)));
+    }
+
+    template <typename Container>
+    struct IsPointerWritable : public std::false_type {};
+
+    template <typename T, typename Allocator>
+    struct IsPointerWritable<std::vector<T, Allocator>> : public std::bool_constant<
+            std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && !std::is_same_v<T, bool>> {};
+
+    /* Запись в std::vector тривиально копируемых значений: вектор один раз увеличивается на число строк,
+     *  после чего значения записываются через указатель без проверок емкости в цикле.
+     */
+    template <typename Container>
+    class PointerColumn {
+    public:
+        PointerColumn(Container& container, size_t rows) {
+            size_t old_size = container.size();
+            container.resize(old_size + rows);
+            next_ = container.data() + old_size;
+        }
+
+        template <typename Value>
+        inline void Write(Value&& value) { *next_++ = std::forward<Value>(value); }
+
+    private:
+        typename Container::value_type* next_;
+    };
+
+    // Запись в конец произвольного контейнера с методом push_back. Если длина источника известна,
+    //  память резервируется один раз до обхода.
+    template <typename Container>
+    class BackColumn {
+    public:
+        BackColumn(Container& container, size_t rows) : container_(container) {
+            if constexpr (HasReserveMethod<Container>::value) {
+                if (rows != kUnknownSize)
+                    container.reserve(container.size() + rows);
+            }
+        }
+
+        template <typename Value>
+        inline void Write(Value&& value) { container_.push_back(std::forward<Value>(value)); }
+
+    private:
+        Container& container_;
+    };
+
+    template <typename Container, typename = void>
+    struct HasCapacityMethod : public std::false_type {};
+
+    template <typename Container>
+    struct HasCapacityMethod<Container, std::void_t<decltype(std::declval<const Container&>().capacity())>> : public std::true_type {};
+
+    template <typename Container, bool Sized>
+    using ColumnWriter = std::conditional_t<Sized && IsPointerWritable<Container>::value, PointerColumn<Container>, BackColumn<Container>>;
+
+    template <size_t... Indexes, typename Writers, typename Row, size_t... Positions>
+    inline void WriteRow(Writers& writers, Row&& row, std::index_sequence<Positions...>) {
+        (std::get<Positions>(writers).Write(RowElement<Indexes>(std::forward<Row>(row))), ...);
+    }
+
+    template <size_t... Indexes, typename Range, typename... Containers>
+    size_t Unzip(Range& range, Containers&... containers) {
+        static_assert(sizeof...(Indexes) == sizeof...(Containers), "one container is required for each unzipped element");
+        constexpr bool sized = kSizedRange<Range>;
+        size_t rows = kUnknownSize;
+        if constexpr (sized)
+            rows = RangeSize(range);
+        std::tuple<ColumnWriter<Containers, sized>...> writers(ColumnWriter<Containers, sized>(containers, rows)...);
+
+        size_t count = 0;
+        for (auto&& row : range) {
+            WriteRow<Indexes...>(writers, std::forward<decltype(row)>(row), std::index_sequence_for<Containers...>{});
+            ++count;
+        }
+        return count;
+    }
+
+    template <typename Container>
+    auto AppendedData(Container& container, size_t rows) {
+        size_t old_size = container.size();
+        container.resize(old_size + rows);
+        return container.data() + old_size;
+    }
+
+    template <size_t... Indexes, typename Iterator, typename Outputs, size_t... Positions>
+    void UnzipRows(Iterator it, size_t first, size_t last, Outputs& outputs, std::index_sequence<Positions...>) {
+        for (size_t row = first; row < last; ++row, ++it) {
+            auto&& values = *it;
+            ((std::get<Positions>(outputs)[row] = RowElement<Indexes>(std::forward<decltype(values)>(values))), ...);
+        }
+    }
+
+    template <size_t... Indexes, typename Range, typename... Containers>
+    size_t UnzipParallel(Range& range, size_t threads, Containers&... containers) {
+        static_assert(sizeof...(Indexes) == sizeof...(Containers), "one container is required for each unzipped element");
+        static_assert(kRandomAccessRange<Range>, "unzip_parallel requires a random access range");
+        if (threads <= 1)
+            return Unzip<Indexes...>(range, containers...);
+
+        using difference_type = typename std::iterator_traits<range_iterator_t<Range>>::difference_type;
+        auto first = std::begin(range);
+        size_t rows = RangeSize(range);
+        std::tuple<decltype(containers.data())...> outputs(AppendedData(containers, rows)...);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t part = 0; part < threads; ++part) {
+            size_t part_first = rows * part / threads;
+            size_t part_last = rows * (part + 1) / threads;
+            workers.emplace_back([=, &outputs] {
+                UnzipRows<Indexes...>(first + static_cast<difference_type>(part_first), part_first, part_last,
+                                      outputs, std::index_sequence_for<Containers...>{});
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        return rows;
+    }
+
+    // Итератор вывода, записывающий I-й элемент каждой присвоенной строки в I-й итератор вывода.
+    // Хранимые итераторы продвигаются при присваивании, поэтому инкремент самого итератора ничего не делает и, как у
+    //  std::back_insert_iterator, возвращает ссылку на этот же итератор: *out++ = row записывает через исходный итератор.
+    template <typename... Iters>
+    class ZipOutputIterator {
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        explicit ZipOutputIterator(Iters... iterators) : iterators_(std::move(iterators)...) {}
+
+        template <typename Row, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Row>, ZipOutputIterator>>>
+        ZipOutputIterator& operator=(Row&& row) {
+            Assign(std::forward<Row>(row), std::index_sequence_for<Iters...>{});
+            return *this;
+        }
+
+        inline ZipOutputIterator& operator*() { return *this; }
+        inline ZipOutputIterator& operator++() { return *this; }
+        inline ZipOutputIterator& operator++(int) { return *this; }
+
+        // Хранимые итераторы, например, указатели на позиции после последних записанных элементов.
+        inline const std::tuple<Iters...>& AsTuple() const { return iterators_; }
+
+    private:
+        template <typename Row, size_t... Indexes>
+        inline void Assign(Row&& row, std::index_sequence<Indexes...>) {
+            ((*std::get<Indexes>(iterators_) = RowElement<Indexes>(std::forward<Row>(row)), ++std::get<Indexes>(iterators_)), ...);
+        }
+
+        std::tuple<Iters...> iterators_;
+    };
+
+    /* Итератор вывода, добавляющий элементы строк в конец нескольких контейнеров.
+     * Вместо того чтобы каждый контейнер независимо увеличивал емкость при push_back, память резервируется
+     *  одновременно во всех контейнерах партиями, размер которых растет в геометрической прогрессии,
+     *  поэтому в цикле записи проверяется только один счетчик.
+     */
+    template <typename... Containers>
+    class ZipBackInserter {
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        explicit ZipBackInserter(Containers&... containers) : containers_(&containers...) {}
+
+        template <typename Row, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Row>, ZipBackInserter>>>
+        ZipBackInserter& operator=(Row&& row) {
+            if (written_ == reserved_)
+                reserve(std::max(kMinBatch, written_));
+            Append(std::forward<Row>(row), std::index_sequence_for<Containers...>{});
+            ++written_;
+            return *this;
+        }
+
+        inline ZipBackInserter& operator*() { return *this; }
+        inline ZipBackInserter& operator++() { return *this; }
+        inline ZipBackInserter& operator++(int) { return *this; }
+
+        // Резервирует во всех контейнерах память еще для rows строк, например, если их количество известно заранее.
+        void reserve(size_t rows) {
+            std::apply([rows](auto*... containers) { (ReserveBatch(*containers, rows), ...); }, containers_);
+            reserved_ = written_ + rows;
+        }
+
+    private:
+        static constexpr size_t kMinBatch = 16;
+
+        // Емкость увеличивается не менее чем вдвое, чтобы добавление в уже большой контейнер оставалось амортизированно O(1).
+        template <typename Container>
+        static void ReserveBatch(Container& container, size_t rows) {
+            if constexpr (HasReserveMethod<Container>::value && HasCapacityMethod<Container>::value) {
+                size_t required = container.size() + rows;
+                if (container.capacity() < required)
+                    container.reserve(std::max(required, 2 * container.capacity()));
+            }
+        }
+
+        template <typename Row, size_t... Indexes>
+        inline void Append(Row&& row, std::index_sequence<Indexes...>) {
+            (std::get<Indexes>(containers_)->push_back(RowElement<Indexes>(std::forward<Row>(row))), ...);
+        }
+
+        std::tuple<Containers*...> containers_;
+        size_t written_ = 0;
+        size_t reserved_ = 0;
+    };
+
+    template <typename Range, typename... Containers, size_t... Indexes>
+    size_t UnzipAll(std::index_sequence<Indexes...>, Range& range, Containers&... containers) {
+        return Unzip<Indexes...>(range, containers...);
+    }
+
+    template <typename Range, typename... Containers, size_t... Indexes>
+    size_t UnzipAllParallel(std::index_sequence<Indexes...>, Range& range, size_t threads, Containers&... containers) {
+        return UnzipParallel<Indexes...>(range, threads, containers...);
+    }
+}
+
+
+namespace zipcpp {
+    /* Операция, обратная zip: I-й элемент каждой строки range добавляется в конец I-го контейнера.
+     * Строками могут быть кортежи Zip, std::tuple, std::pair или типы с функцией get<I>, находимой через ADL.
+     * Все контейнеры заполняются за один проход по range. Если длина range известна до обхода (метод size()
+     *  или итераторы произвольного доступа), память в контейнерах резервируется один раз, а в std::vector
+     *  тривиально копируемых значений элементы записываются через указатель.
+     * Для перемещения значений вместо копирования можно передать move_zip или диапазон std::move_iterator.
+     * Возвращает количество обработанных строк.
+     */
+    template <typename Range, typename... Containers>
+    size_t unzip(Range&& range, Containers&... containers) {
+        return zip_impl::UnzipAll(std::index_sequence_for<Containers...>{}, range, containers...);
+    }
+
+    // То же, что unzip, но в контейнеры добавляются только элементы с номерами Indexes..., например:
+    //  unzip_into<2, 0>(rows, prices, names).
+    template <size_t... Indexes, typename Range, typename... Containers>
+    size_t unzip_into(Range&& range, Containers&... containers) {
+        return zip_impl::Unzip<Indexes...>(range, containers...);
+    }
+
+    /* Параллельный вариант unzip для диапазонов с произвольным доступом и контейнеров с методами resize и data
+     *  (например, std::vector, кроме std::vector<bool>). Контейнеры увеличиваются на длину range,
+     *  после чего каждый из threads потоков заполняет свою часть строк.
+     */
+    template <typename Range, typename... Containers>
+    size_t unzip_parallel(Range&& range, size_t threads, Containers&... containers) {
+        return zip_impl::UnzipAllParallel(std::index_sequence_for<Containers...>{}, range, threads, containers...);
+    }
+
+    template <size_t... Indexes, typename Range, typename... Containers>
+    size_t unzip_into_parallel(Range&& range, size_t threads, Containers&... containers) {
+        return zip_impl::UnzipParallel<Indexes...>(range, threads, containers...);
+    }
+
+    /* Итератор вывода для нескольких итераторов вывода: присваивание *out = row записывает I-й элемент строки
+     *  (кортежа Zip, std::tuple, std::pair) в I-й итератор, например:
+     *   std::copy(rows.begin(), rows.end(), zip_output(std::back_inserter(x), std::back_inserter(y)));
+     */
+    template <typename... Iters>
+    auto zip_output(Iters... iterators) {
+        return zip_impl::ZipOutputIterator<Iters...>(std::move(iterators)...);
+    }
+
+    // Итератор вывода, добавляющий элементы строк в конец контейнеров, резервируя память во всех контейнерах одновременно.
+    template <typename... Containers>
+    auto zip_back_inserter(Containers&... containers) {
+        return zip_impl::ZipBackInserter<Containers...>(containers...);
+    }
+}